@@ -87,12 +87,36 @@ class Source: public Driver
     const char* name_;
   };
 
+static void print_statistics(KStatistics const *statistics, void *)
+  {
+  std::cout
+    << "restarts: " << statistics->restarts
+    << ", decisions: " << statistics->decisions
+    << ", propagations: " << statistics->propagations
+    << ", conflicts: " << statistics->conflicts
+    << ", learnts: " << statistics->learnts
+    << (statistics->solved_by_propagation ? ", solved by propagation" : "")
+    << std::endl;
+  }
+
 int main(int argc, char* argv[])
   {
   std::string dotfile;
+  std::string dimacs;
   std::string machine;
   std::string sysname;
+  std::string warm_start;
   std::vector<std::string> request_urls;
+  bool modern_search = false;
+  bool statistics = false;
+  bool explain = false;
+  int portfolio = 0;
+  int conflict_limit = 0;
+  int timeout = 0;
+  int minimize_sources = 0;
+  int minimize_implementations = 0;
+  int minimize_staleness = 0;
+  int alternatives = 0;
   try
     {
     namespace po = boost::program_options;
@@ -101,8 +125,20 @@ int main(int argc, char* argv[])
       ("help,h", "produce help message")
       ("version,v", "print version string")
       ("dotfile,d", po::value(&dotfile), "output graphviz dot file")
+      ("dimacs", po::value(&dimacs), "output the SAT instance as DIMACS file")
       ("sysname,s", po::value(&sysname), "the system name")
       ("machine,m", po::value(&machine), "the hardware name")
+      ("modern-search", "use activity based decisions and restarts")
+      ("portfolio,p", po::value(&portfolio), "number of parallel solvers")
+      ("warm-start,w", po::value(&warm_start), "reuse the solver state of the previous run, which may keep its versions over preferred ones")
+      ("conflict-limit", po::value(&conflict_limit), "give up after this many conflicts")
+      ("timeout,t", po::value(&timeout), "give up after this many milliseconds of solving")
+      ("statistics", "print the effort of the SAT search")
+      ("explain", "print a minimal set of conflicting constraints if there is no solution")
+      ("minimize-sources", po::value(&minimize_sources), "weight of each source build in the objective")
+      ("minimize-implementations", po::value(&minimize_implementations), "weight of each implementation in the objective")
+      ("minimize-staleness", po::value(&minimize_staleness), "weight of each newer version in the objective")
+      ("alternatives", po::value(&alternatives), "number of alternative solutions to print")
       ;
     po::options_description hidden_options("Hidden options");
     hidden_options.add_options()
@@ -132,6 +168,9 @@ int main(int argc, char* argv[])
       std::cout << "Karrot 0.1" << std::endl;
       return 0;
       }
+    modern_search = variables.count("modern-search") > 0;
+    statistics = variables.count("statistics") > 0;
+    explain = variables.count("explain") > 0;
     notify(variables);
     }
   catch (std::exception& error)
@@ -153,11 +192,45 @@ int main(int argc, char* argv[])
       {
       engine.dot_filename(dotfile.c_str());
       }
-    if (!engine.run())
+    if (!dimacs.empty())
+      {
+      engine.dimacs_filename(dimacs.c_str());
+      }
+    engine.modern_search(modern_search);
+    engine.portfolio(portfolio);
+    engine.conflict_limit(conflict_limit);
+    engine.timeout(timeout);
+    engine.minimize(minimize_sources, minimize_implementations, minimize_staleness);
+    engine.alternatives(alternatives);
+    engine.explain_conflicts(explain);
+    if (!warm_start.empty())
+      {
+      engine.warm_start(warm_start.c_str());
+      }
+    if (statistics)
+      {
+      engine.progress(print_statistics, nullptr);
+      }
+    bool satisfiable = engine.run();
+    if (statistics)
+      {
+      print_statistics(&engine.statistics(), nullptr);
+      }
+    if (!satisfiable)
       {
       std::cout << "The request is not satisfiable!" << std::endl;
       return -1;
       }
+    int number = 0;
+    for (const auto& alternative : engine.alternatives())
+      {
+      std::cout << "alternative " << ++number << ':' << std::endl;
+      for (const Implementation& impl : alternative)
+        {
+        std::cout << "  " << impl.name() << ' ' << impl.version()
+          << ' ' << impl.component() << std::endl;
+        }
+      }
     }
   catch (std::exception const& error)
     {
@@ -14,6 +14,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include <cstdio>
 
 class Dictionary;
@@ -216,15 +217,82 @@ class Engine
       {
       k_engine_setopt(self, K_OPT_DOT_FILENAME, filename);
       }
+    void dimacs_filename(char const *filename)
+      {
+      k_engine_setopt(self, K_OPT_DIMACS_FILENAME, filename);
+      }
+    void modern_search(bool enable)
+      {
+      k_engine_setopt(self, K_OPT_MODERN_SEARCH, int(enable));
+      }
+    void portfolio(int solvers)
+      {
+      k_engine_setopt(self, K_OPT_PORTFOLIO, solvers);
+      }
+    void warm_start(char const *filename)
+      {
+      k_engine_setopt(self, K_OPT_WARM_START, filename);
+      }
+    void minimize(int sources, int implementations, int staleness)
+      {
+      k_engine_setopt(self, K_OPT_MINIMIZE_SOURCES, sources);
+      k_engine_setopt(self, K_OPT_MINIMIZE_IMPLEMENTATIONS, implementations);
+      k_engine_setopt(self, K_OPT_MINIMIZE_STALENESS, staleness);
+      }
+    void incremental(bool enable)
+      {
+      k_engine_setopt(self, K_OPT_INCREMENTAL, int(enable));
+      }
+    void conflict_limit(int conflicts)
+      {
+      k_engine_setopt(self, K_OPT_SOLVE_CONFLICT_LIMIT, conflicts);
+      }
+    void timeout(int milliseconds)
+      {
+      k_engine_setopt(self, K_OPT_SOLVE_TIMEOUT_MS, milliseconds);
+      }
+    void progress(KProgressFun function, void *data)
+      {
+      k_engine_setopt(self, K_OPT_PROGRESS_FUNCTION, function);
+      k_engine_setopt(self, K_OPT_PROGRESS_DATA, data);
+      }
+    KStatistics const& statistics()
+      {
+      return *k_engine_get_statistics(self);
+      }
+    void explain_conflicts(bool enable)
+      {
+      k_engine_setopt(self, K_OPT_EXPLAIN_CONFLICTS, int(enable));
+      }
+    void alternatives(int count)
+      {
+      k_engine_setopt(self, K_OPT_ALTERNATIVES, count);
+      }
+    std::vector<std::vector<Implementation>> alternatives()
+      {
+      std::vector<std::vector<Implementation>> result;
+      k_engine_foreach_alternative(self, model_fun, &result);
+      return result;
+      }
     bool run()
       {
       int result = k_engine_run(self);
-      if (result < 0)
+      if (result < 0 || result == 2)
         {
         throw std::runtime_error(k_engine_error_message(self));
         }
       return result == 0;
       }
+  private:
+    static void model_fun(KImplementation const *const *model, size_t size, void *self)
+      {
+      auto alternatives = static_cast<std::vector<std::vector<Implementation>>*>(self);
+      alternatives->emplace_back();
+      for (size_t i = 0; i < size; ++i)
+        {
+        alternatives->back().push_back(Implementation(model[i]));
+        }
+      }
   private:
     KEngine *self;
   };
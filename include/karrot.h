@@ -41,12 +41,15 @@ typedef struct _KDictionary KDictionary;
 typedef struct _KImplementation KImplementation;
 typedef struct _KDriver KDriver;
 typedef struct _KEngine KEngine;
+typedef struct _KStatistics KStatistics;
 
 typedef void (*KAddFun) (char const **val, int size, int native, void *self);
 typedef void (*KDownload) (KImplementation const *impl, int requested, KError *error, void *self);
 typedef void (*KFilter) (KDictionary const *fields, KAddFun fun, void *target, void *self);
 typedef void (*KMapping) (char const *key, char const *val, void *self);
 typedef void (*KPrintFun) (char const *string);
+typedef void (*KProgressFun) (KStatistics const *statistics, void *self);
+typedef void (*KModelFun) (KImplementation const *const *model, size_t size, void *self);
 
 KARROT_API char const *
 k_version (int *major, int *minor, int *patch);
@@ -89,14 +92,38 @@ struct _KDriver
   void (*destroy_target) (void*);
   };
 
+struct _KStatistics
+  {
+  long long restarts;
+  long long decisions;
+  long long propagations;
+  long long conflicts;
+  long long learnts;
+  int solved_by_propagation;  /* nonzero if no search was needed */
+  };
+
 enum _KOption
   {
-  K_OPT_LOG_FUNCTION            = (1u << 0),
-  K_OPT_DOT_FILENAME            = (1u << 1),
-  K_OPT_FEED_CACHE              = (1u << 2),
-  K_OPT_RELOAD_FEEDS            = (1u << 3),
-  K_OPT_IGNORE_SOURCE_CONFLICTS = (1u << 4),
-  K_OPT_NO_TOPOLOGICAL_ORDER    = (1u << 5),
+  K_OPT_LOG_FUNCTION             = (1u << 0),
+  K_OPT_DOT_FILENAME             = (1u << 1),
+  K_OPT_FEED_CACHE               = (1u << 2),
+  K_OPT_RELOAD_FEEDS             = (1u << 3),
+  K_OPT_IGNORE_SOURCE_CONFLICTS  = (1u << 4),
+  K_OPT_NO_TOPOLOGICAL_ORDER     = (1u << 5),
+  K_OPT_MODERN_SEARCH            = (1u << 6),
+  K_OPT_PORTFOLIO                = (1u << 7),
+  K_OPT_INCREMENTAL              = (1u << 8),
+  K_OPT_WARM_START               = (1u << 9),
+  K_OPT_SOLVE_CONFLICT_LIMIT     = (1u << 10),
+  K_OPT_SOLVE_TIMEOUT_MS         = (1u << 11),
+  K_OPT_PROGRESS_FUNCTION        = (1u << 12),
+  K_OPT_PROGRESS_DATA            = (1u << 13),
+  K_OPT_DIMACS_FILENAME          = (1u << 14),
+  K_OPT_MINIMIZE_SOURCES         = (1u << 15),
+  K_OPT_MINIMIZE_IMPLEMENTATIONS = (1u << 16),
+  K_OPT_MINIMIZE_STALENESS       = (1u << 17),
+  K_OPT_ALTERNATIVES             = (1u << 18),
+  K_OPT_EXPLAIN_CONFLICTS        = (1u << 19),
   };
 
 typedef enum _KOption KOption;
@@ -148,8 +175,13 @@ k_engine_setopt (KEngine *self, KOption option, ...);
 /**
  * Run the Engine.
  *
+ * If the request is not satisfiable and `K_OPT_EXPLAIN_CONFLICTS` is set,
+ * a minimal set of conflicting requests and feed constraints is logged.
+ *
  * @param self a `KEngine` instance
- * @return zero indicates success
+ * @return zero indicates success, one that the request is not satisfiable,
+ *   two that a solve limit was reached before this was decided, and a
+ *   negative value an error; see `k_engine_error_message` for the last two
  */
 KARROT_API int
 k_engine_run (KEngine *self);
@@ -163,6 +195,38 @@ k_engine_run (KEngine *self);
 KARROT_API char const *
 k_engine_error_message (KEngine *self);
 
+/**
+ * Get the effort of the SAT search of the last run of the Engine.
+ *
+ * The same statistics are passed to the `K_OPT_PROGRESS_FUNCTION` before
+ * each restart of the search, together with the `K_OPT_PROGRESS_DATA`.
+ * With a portfolio, the progress is that of the first solver only, while
+ * these statistics are summed over all solvers.
+ *
+ * @param self a `KEngine` instance
+ * @return the statistics; if no search was needed because propagation
+ *   selected every reachable implementation, the counters are zero and
+ *   `solved_by_propagation` is nonzero
+ */
+KARROT_API KStatistics const *
+k_engine_get_statistics (KEngine *self);
+
+/**
+ * Iterate over the alternative solutions of the last run of the Engine.
+ *
+ * Up to `K_OPT_ALTERNATIVES` further solutions are enumerated from the same
+ * solver after the one that was handled, each selecting a set of
+ * implementations that is neither equal to nor a superset of an earlier
+ * one. Their implementations are not handled by the drivers, and they are
+ * in topological order unless `K_OPT_NO_TOPOLOGICAL_ORDER` is set.
+ *
+ * @param self a `KEngine` instance
+ * @param fun the function to call for each alternative, in the order found
+ * @param target passed to `fun` as its last argument
+ */
+KARROT_API void
+k_engine_foreach_alternative (KEngine *self, KModelFun fun, void *target);
+
 /**
  * Engine destructor
  *
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "core.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Karrot
+{
+
+typedef std::chrono::steady_clock Clock;
+
+bool minimize_core(
+    Solver& solver,
+    vec<Lit>& core,
+    double time_budget,
+    KPrintFun log)
+  {
+  const Clock::time_point start = Clock::now();
+  bool minimal = true;
+  int i = 0;
+  while (i < core.size())
+    {
+    vec<Lit> rest;
+    for (int k = 0; k < core.size(); ++k)
+      {
+      if (k != i)
+        {
+        rest.push(core[k]);
+        }
+      }
+    if (time_budget >= 0)
+      {
+      std::chrono::duration<double> elapsed = Clock::now() - start;
+      solver.time_budget = std::max(0.0, time_budget - elapsed.count());
+      }
+    const lbool status = solver.solveLimited(rest, log);
+    if (status != l_False)
+      {
+      // core[i] is needed, or we cannot tell.
+      minimal = minimal && status == l_True;
+      ++i;
+      continue;
+      }
+    // The conflict is a subset of 'rest'. The first 'i' assumptions are
+    // kept anyway: each was needed by a superset of the conflict, so the
+    // conflict contains it, unless a budget ran out while it was tested.
+    vec<Lit> next;
+    for (int k = 0; k < i; ++k)
+      {
+      next.push(core[k]);
+      }
+    for (int k = 0; k < solver.conflict.size(); ++k)
+      {
+      const Lit p = ~solver.conflict[k];
+      bool kept = false;
+      for (int j = 0; j < i; ++j)
+        {
+        kept = kept || core[j] == p;
+        }
+      if (!kept)
+        {
+        next.push(p);
+        }
+      }
+    next.copyTo(core);
+    }
+  return minimal;
+  }
+
+} // namespace Karrot
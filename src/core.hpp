@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_CORE_HPP
+#define KARROT_CORE_HPP
+
+#include "minisat/Solver.h"
+
+namespace Karrot
+{
+
+// Shrinks 'core', a set of assumptions under which 'solver' is not
+// satisfiable, until dropping any one of them makes it satisfiable. Each
+// assumption is dropped in turn; if the rest is still unsatisfiable, the
+// conflict of the solver replaces the core (deletion-based, with clause set
+// refinement). All calls use the same solver, so learnt clauses carry over.
+//
+// 'time_budget' (in seconds, negative for no limit) covers all calls, while
+// the conflict budget of the solver applies to each call. Returns false if a
+// budget ran out; the core is still unsatisfiable then, but may not be
+// minimal.
+bool minimize_core(
+    Solver& solver,
+    vec<Lit>& core,
+    double time_budget,
+    KPrintFun log);
+
+} // namespace Karrot
+
+#endif /* KARROT_CORE_HPP */
@@ -8,75 +8,120 @@
 
 #include "dependencies.hpp"
 #include "feed_queue.hpp"
-#include <boost/logic/tribool.hpp>
 
 namespace Karrot
 {
 
-void Dependencies::replay(
+const Dependencies::Result* Dependencies::replay(
     const std::string& component,
     const std::string& version,
-    const KDictionary& values,
-    std::vector<Spec>& depends,
-    std::vector<Spec>& conflicts) const
+    const KDictionary& values)
   {
   if (component != name && component != "*")
     {
-    return;
+    return nullptr;
     }
-  std::vector<boost::tribool> stack{true};
-  for (const Entry& entry : deps)
+  std::map<KDictionary, Result>& by_variant = cache[version];
+  auto it = by_variant.find(values);
+  if (it != by_variant.end())
     {
-    switch (entry.first)
+    return &it->second;
+    }
+  if (next_branch.size() != deps.size())
+    {
+    compile();
+    }
+  Result result = evaluate(version, values);
+  for (const Spec& spec : result.depends)
+    {
+    feed_queue->push(spec);
+    }
+  return &by_variant.insert(std::make_pair(values, std::move(result))).first->second;
+  }
+
+// Resolve the jump targets of all conditional chains, so that evaluation can
+// skip the branches that are not taken instead of walking through them.
+void Dependencies::compile()
+  {
+  next_branch.assign(deps.size(), deps.size());
+  end_chain.assign(deps.size(), deps.size());
+  std::vector<std::vector<std::size_t>> chains;
+  for (std::size_t i = 0; i < deps.size(); ++i)
+    {
+    switch (deps[i].first)
       {
       case IF:
-        if (stack.back() == true)
-          {
-          stack.push_back(entry.second.query.evaluate(version, values));
-          }
-        else
-          {
-          stack.push_back(boost::indeterminate);
-          }
+        chains.emplace_back(1, i);
         break;
       case ELSE:
-        if (stack.back() == true)
-          {
-          stack.back() = boost::indeterminate;
-          }
-        else if (stack.back() == false)
+      case ELSEIF:
+        if (!chains.empty())
           {
-          stack.back() = true;
+          next_branch[chains.back().back()] = i;
+          chains.back().push_back(i);
           }
         break;
-      case ELSEIF:
-        if (stack.back() == true)
+      case ENDIF:
+        if (!chains.empty())
           {
-          stack.back() = boost::indeterminate;
+          next_branch[chains.back().back()] = i;
+          for (std::size_t branch : chains.back())
+            {
+            end_chain[branch] = i;
+            }
+          chains.pop_back();
           }
-        else if (stack.back() == false)
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+Dependencies::Result Dependencies::evaluate(
+    const std::string& version,
+    const KDictionary& values) const
+  {
+  std::vector<Spec> depends;
+  std::vector<Spec> conflicts;
+  std::size_t i = 0;
+  while (i < deps.size())
+    {
+    const Entry& entry = deps[i];
+    switch (entry.first)
+      {
+      case IF:
+        // find the first branch of the chain that is taken
+        while (i < deps.size() &&
+            deps[i].first != ELSE && deps[i].first != ENDIF &&
+            !deps[i].second.query.evaluate(version, values))
           {
-          stack.back() = entry.second.query.evaluate(version, values);
+          i = next_branch[i];
           }
+        ++i;
+        break;
+      case ELSE:
+      case ELSEIF:
+        // reached the end of a taken branch
+        i = end_chain[i] + 1;
         break;
       case ENDIF:
-        stack.pop_back();
+        ++i;
         break;
       case DEPENDS:
-        if (stack.back())
-          {
-          feed_queue->push(entry.second);
-          depends.push_back(entry.second);
-          }
+        depends.push_back(entry.second);
+        ++i;
         break;
       case CONFLICTS:
-        if (stack.back())
-          {
-          conflicts.push_back(entry.second);
-          }
+        conflicts.push_back(entry.second);
+        ++i;
         break;
       }
     }
+  Result result;
+  result.depends = SpecList(std::move(depends));
+  result.conflicts = SpecList(std::move(conflicts));
+  return result;
   }
 
 } // namespace Karrot
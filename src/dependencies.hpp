@@ -10,6 +10,8 @@
 #define KARROT_DEPENDENCIES_HPP
 
 #include "spec.hpp"
+#include "dictionary.hpp"
+#include <map>
 
 namespace Karrot
 {
@@ -58,12 +60,19 @@ class Dependencies
       {
       deps.emplace_back(CONFLICTS, spec);
       }
-    void replay(
+    class Result
+      {
+      public:
+        SpecList depends;
+        SpecList conflicts;
+      };
+    // Returns the dependencies that apply to the given component, version and
+    // variant, or a null pointer if this list does not apply to the component.
+    // Results are memoized per version and variant.
+    const Result* replay(
         const std::string& component,
         const std::string& version,
-        const KDictionary& values,
-        std::vector<Spec>& depends,
-        std::vector<Spec>& conflicts) const;
+        const KDictionary& values);
   private:
     enum Code
       {
@@ -74,9 +83,17 @@ class Dependencies
       DEPENDS,
       CONFLICTS,
       };
+    void compile();
+    Result evaluate(const std::string& version, const KDictionary& values) const;
+  private:
     std::string name;
     typedef std::pair<Code, Spec> Entry;
     std::vector<Entry> deps;
+    // For every IF, ELSEIF and ELSE: the index of the next branch of the same
+    // chain and the index of the ENDIF that closes the chain.
+    std::vector<std::size_t> next_branch;
+    std::vector<std::size_t> end_chain;
+    std::map<std::string, std::map<KDictionary, Result>> cache;
     FeedQueue* feed_queue;
   };
 
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "dimacs.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace Karrot
+{
+
+// The file looks like this, with all lists terminated by 0:
+//
+//   c karrot sat instance
+//   c nondecision <variables>
+//   c preferences <variables, bottom of the stack first>
+//   c assumptions <literals>
+//   p cnf <variables> <clauses>
+//   <clauses>
+void write_dimacs(const std::string& filename, const Instance& instance)
+  {
+  std::ofstream file(filename);
+  if (!file)
+    {
+    throw std::runtime_error("cannot write DIMACS file: " + filename);
+    }
+  const Formula& formula = instance.formula;
+  file << "c karrot sat instance\n";
+  file << "c nondecision";
+  for (Var v = 0; v < formula.nVars(); ++v)
+    {
+    if (!formula.decision(v))
+      {
+      file << ' ' << v + 1;
+      }
+    }
+  file << " 0\nc preferences";
+  for (Var v : instance.preferences)
+    {
+    file << ' ' << v + 1;
+    }
+  file << " 0\nc assumptions";
+  for (Lit p : instance.assumptions)
+    {
+    file << ' ' << toDimacs(p);
+    }
+  file << " 0\np cnf " << formula.nVars() << ' ' << formula.clauses.size() << '\n';
+  for (const std::vector<Lit>& clause : formula.clauses)
+    {
+    for (Lit p : clause)
+      {
+      file << toDimacs(p) << ' ';
+      }
+    file << "0\n";
+    }
+  }
+
+static void invalid(const std::string& filename, const std::string& what)
+  {
+  throw std::runtime_error("invalid DIMACS file '" + filename + "': " + what);
+  }
+
+// Reads numbers up to the terminating 0.
+static std::vector<int> read_list(std::istream& stream)
+  {
+  std::vector<int> result;
+  int number;
+  while (stream >> number && number != 0)
+    {
+    result.push_back(number);
+    }
+  return result;
+  }
+
+Instance read_dimacs(const std::string& filename)
+  {
+  std::ifstream file(filename);
+  if (!file)
+    {
+    throw std::runtime_error("cannot read DIMACS file: " + filename);
+    }
+  int vars = -1;
+  std::size_t clauses = 0;
+  std::vector<int> nondecision;
+  std::vector<int> preferences;
+  std::vector<int> assumptions;
+  std::vector<std::vector<int>> literals;
+  std::vector<int> clause;
+  std::string line;
+  while (std::getline(file, line))
+    {
+    std::istringstream stream(line);
+    std::string word;
+    if (line.empty() || line[0] == 'c')
+      {
+      stream >> word >> word;
+      if (word == "nondecision")
+        {
+        nondecision = read_list(stream);
+        }
+      else if (word == "preferences")
+        {
+        preferences = read_list(stream);
+        }
+      else if (word == "assumptions")
+        {
+        assumptions = read_list(stream);
+        }
+      continue;
+      }
+    if (line[0] == 'p')
+      {
+      if (!(stream >> word >> word >> vars >> clauses) || word != "cnf" || vars < 0)
+        {
+        invalid(filename, "bad problem line");
+        }
+      continue;
+      }
+    if (vars < 0)
+      {
+      invalid(filename, "clause before problem line");
+      }
+    int number;
+    while (stream >> number)
+      {
+      if (number == 0)
+        {
+        literals.push_back(clause);
+        clause.clear();
+        }
+      else
+        {
+        clause.push_back(number);
+        }
+      }
+    if (!stream.eof())
+      {
+      invalid(filename, "bad clause: " + line);
+      }
+    }
+  if (vars < 0)
+    {
+    invalid(filename, "missing problem line");
+    }
+  if (!clause.empty() || literals.size() != clauses)
+    {
+    invalid(filename, "number of clauses does not match the problem line");
+    }
+
+  Instance instance;
+  std::vector<bool> decision(vars, true);
+  auto variable = [&](int number) -> Var
+    {
+    if (number == 0 || std::abs(number) > vars)
+      {
+      invalid(filename, "variable out of range");
+      }
+    return std::abs(number) - 1;
+    };
+  auto literal = [&](int number)
+    {
+    return Lit(variable(number), number < 0);
+    };
+  for (int number : nondecision)
+    {
+    decision[variable(number)] = false;
+    }
+  for (int v = 0; v < vars; ++v)
+    {
+    instance.formula.newVar(decision[v]);
+    }
+  for (int number : preferences)
+    {
+    instance.preferences.push_back(variable(number));
+    }
+  for (int number : assumptions)
+    {
+    instance.assumptions.push_back(literal(number));
+    }
+  for (const std::vector<int>& numbers : literals)
+    {
+    instance.formula.clauses.emplace_back();
+    for (int number : numbers)
+      {
+      instance.formula.clauses.back().push_back(literal(number));
+      }
+    }
+  return instance;
+  }
+
+} // namespace Karrot
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_DIMACS_HPP
+#define KARROT_DIMACS_HPP
+
+#include "simplify.hpp"
+#include <string>
+#include <vector>
+
+namespace Karrot
+{
+
+// A SAT instance exactly as it is passed to the Solver: the formula, the
+// preference stack (decided last element first) and the assumptions of the
+// request.
+class Instance
+  {
+  public:
+    Formula formula;
+    std::vector<Var> preferences;
+    std::vector<Lit> assumptions;
+  };
+
+// Writes DIMACS CNF. The non-decision variables, the preferences and the
+// assumptions go into comment lines, so that other solvers can read the
+// file as well.
+void write_dimacs(const std::string& filename, const Instance& instance);
+
+// Throws std::runtime_error if the file cannot be read.
+Instance read_dimacs(const std::string& filename);
+
+} // namespace Karrot
+
+#endif /* KARROT_DIMACS_HPP */
@@ -31,14 +31,36 @@ struct _KEngine
     : namespace_uri(namespace_uri)
     , feed_cache(".")
     , reload_feeds(false)
-    , ignore_source_conflicts(false)
+    , solver_database_size(0)
     , no_topological_order(false)
     , log_function{[](char const*){}}
+    , progress_function(nullptr)
+    , progress_data(nullptr)
+    , statistics()
     {
     if (this->namespace_uri.back() != '/')
       {
       this->namespace_uri += '/';
       }
+    solve_options.progress = [this](const Karrot::SolveStatistics& progress)
+      {
+      if (progress_function)
+        {
+        KStatistics current = make_statistics(progress);
+        progress_function(&current, progress_data);
+        }
+      };
+    }
+  static KStatistics make_statistics(const Karrot::SolveStatistics& statistics)
+    {
+    KStatistics result;
+    result.restarts = statistics.restarts;
+    result.decisions = statistics.decisions;
+    result.propagations = statistics.propagations;
+    result.conflicts = statistics.conflicts;
+    result.learnts = statistics.learnts;
+    result.solved_by_propagation = statistics.solved_by_propagation;
+    return result;
     }
   std::string error;
   std::string namespace_uri;
@@ -49,9 +71,15 @@ struct _KEngine
   std::string dot_filename;
   std::string feed_cache;
   bool reload_feeds;
-  bool ignore_source_conflicts;
+  Karrot::SolveOptions solve_options;
+  std::unique_ptr<Karrot::IncrementalSolver> solver;
+  std::size_t solver_database_size;
   bool no_topological_order;
   KPrintFun log_function;
+  KProgressFun progress_function;
+  void *progress_data;
+  KStatistics statistics;
+  std::vector<std::vector<int>> alternatives;
   };
 
 KEngine *
@@ -106,7 +134,57 @@ void k_engine_setopt(KEngine *self, KOption option, ...)
       self->reload_feeds = va_arg(arg, int);
       break;
     case K_OPT_IGNORE_SOURCE_CONFLICTS:
-      self->ignore_source_conflicts = va_arg(arg, int);
+      self->solve_options.ignore_source_conflicts = va_arg(arg, int);
+      self->solver.reset();
+      break;
+    case K_OPT_MODERN_SEARCH:
+      self->solve_options.modern_search = va_arg(arg, int);
+      self->solver.reset();
+      break;
+    case K_OPT_PORTFOLIO:
+      self->solve_options.portfolio = va_arg(arg, int);
+      break;
+    case K_OPT_WARM_START:
+      str = va_arg(arg, const char*);
+      self->solve_options.warm_start = str ? str : "";
+      break;
+    case K_OPT_DIMACS_FILENAME:
+      str = va_arg(arg, const char*);
+      self->solve_options.dimacs = str ? str : "";
+      break;
+    case K_OPT_SOLVE_CONFLICT_LIMIT:
+      self->solve_options.conflict_limit = va_arg(arg, int);
+      self->solver.reset();
+      break;
+    case K_OPT_SOLVE_TIMEOUT_MS:
+      self->solve_options.timeout_ms = va_arg(arg, int);
+      self->solver.reset();
+      break;
+    case K_OPT_PROGRESS_FUNCTION:
+      self->progress_function = va_arg(arg, KProgressFun);
+      break;
+    case K_OPT_PROGRESS_DATA:
+      self->progress_data = va_arg(arg, void*);
+      break;
+    case K_OPT_MINIMIZE_SOURCES:
+      self->solve_options.minimize_sources = va_arg(arg, int);
+      break;
+    case K_OPT_MINIMIZE_IMPLEMENTATIONS:
+      self->solve_options.minimize_implementations = va_arg(arg, int);
+      break;
+    case K_OPT_MINIMIZE_STALENESS:
+      self->solve_options.minimize_staleness = va_arg(arg, int);
+      break;
+    case K_OPT_ALTERNATIVES:
+      self->solve_options.alternatives = va_arg(arg, int);
+      self->solver.reset();
+      break;
+    case K_OPT_EXPLAIN_CONFLICTS:
+      self->solve_options.explain_conflicts = va_arg(arg, int);
+      break;
+    case K_OPT_INCREMENTAL:
+      self->solve_options.incremental = va_arg(arg, int);
+      self->solver.reset();
       break;
     case K_OPT_NO_TOPOLOGICAL_ORDER:
       self->no_topological_order = va_arg(arg, int);
@@ -117,7 +195,7 @@ void k_engine_setopt(KEngine *self, KOption option, ...)
   va_end(arg);
   }
 
-static bool engine_run(KEngine *self)
+static Karrot::SolveResult engine_run(KEngine *self)
   {
   using namespace Karrot;
   while (auto spec = self->feed_queue.get_next())
@@ -146,20 +224,68 @@ static bool engine_run(KEngine *self)
       }
     }
   std::vector<int> model;
+  self->statistics = KStatistics();
+  self->alternatives.clear();
   Log(self->log_function, "Solving SAT with %1% variables") % self->database.size();
-  bool solvable = solve(
-      self->database,
-      self->requests,
-      self->ignore_source_conflicts,
-      self->log_function,
-      model);
-  if (!solvable)
+  SolveStatistics statistics;
+  SolveResult result;
+  const SolveOptions& options = self->solve_options;
+  bool incremental = options.incremental;
+  if (incremental && (options.optimizing() || options.explain_conflicts ||
+      options.portfolio > 1 || !options.warm_start.empty() || !options.dimacs.empty()))
+    {
+    self->log_function(
+      "incremental solving is not supported with these options, solving from scratch");
+    incremental = false;
+    }
+  if (incremental)
     {
-    return false;
+    if (!self->solver || self->solver_database_size != self->database.size())
+      {
+      self->solver.reset(new IncrementalSolver(self->database, self->solve_options));
+      self->solver_database_size = self->database.size();
+      }
+    result = self->solver->solve(
+        self->requests,
+        self->log_function,
+        model,
+        self->alternatives,
+        statistics);
+    }
+  else
+    {
+    result = solve(
+        self->database,
+        self->requests,
+        self->solve_options,
+        self->log_function,
+        model,
+        self->alternatives,
+        statistics);
+    }
+  self->statistics = KEngine::make_statistics(statistics);
+  if (result == SolveResult::unknown)
+    {
+    std::stringstream stream;
+    stream
+      << "search limit reached after "
+      << statistics.conflicts << " conflicts, "
+      << statistics.decisions << " decisions and "
+      << statistics.learnts << " learnt clauses; "
+      << "satisfiability is unknown";
+    self->error = stream.str();
+    }
+  if (result != SolveResult::satisfiable)
+    {
+    return result;
     }
   if (!self->no_topological_order)
     {
     model = topological_sort(model, self->database);
+    for (std::vector<int>& alternative : self->alternatives)
+      {
+      alternative = topological_sort(alternative, self->database);
+      }
     }
   if (!self->dot_filename.empty())
     {
@@ -179,14 +305,22 @@ static bool engine_run(KEngine *self)
       impl.driver->download(impl, requested);
       }
     }
-  return true;
+  return SolveResult::satisfiable;
   }
 
 int k_engine_run(KEngine *self)
   {
   try
     {
-    return engine_run(self) ? 0 : 1;
+    switch (engine_run(self))
+      {
+      case Karrot::SolveResult::satisfiable:
+        return 0;
+      case Karrot::SolveResult::unsatisfiable:
+        return 1;
+      case Karrot::SolveResult::unknown:
+        return 2;
+      }
     }
   catch (Karrot::XmlParseError& error)
     {
@@ -211,3 +345,22 @@ char const *k_engine_error_message(KEngine *self)
   {
   return self->error.c_str();
   }
+
+KStatistics const *k_engine_get_statistics(KEngine *self)
+  {
+  return &self->statistics;
+  }
+
+void k_engine_foreach_alternative(KEngine *self, KModelFun fun, void *target)
+  {
+  std::vector<KImplementation const*> model;
+  for (const std::vector<int>& alternative : self->alternatives)
+    {
+    model.clear();
+    for (int i : alternative)
+      {
+      model.push_back(&self->database[i]);
+      }
+    fun(model.data(), model.size(), target);
+    }
+  }
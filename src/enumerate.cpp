@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "enumerate.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Karrot
+{
+
+typedef std::chrono::steady_clock Clock;
+
+int enumerate(
+    Solver& solver,
+    const vec<Lit>& assumptions,
+    int vars,
+    const vec<lbool>& model,
+    int count,
+    double time_budget,
+    KPrintFun log,
+    const std::function<void(const vec<lbool>&)>& found)
+  {
+  const Clock::time_point start = Clock::now();
+  const Var active = solver.newVar(false);
+  vec<Lit> guarded;
+  assumptions.copyTo(guarded);
+  guarded.push(Lit(active));
+
+  // Returns false if nothing is left to block: any other model would be a
+  // superset of the empty one.
+  auto block = [&](const vec<lbool>& blocked) -> bool
+    {
+    vec<Lit> clause;
+    clause.push(~Lit(active));
+    for (Var v = 0; v < vars; ++v)
+      {
+      if (blocked[v] == l_True)
+        {
+        clause.push(~Lit(v));
+        }
+      }
+    if (clause.size() == 1)
+      {
+      return false;
+      }
+    solver.addClause(clause);
+    return true;
+    };
+
+  int result = 0;
+  bool more = block(model);
+  while (more && result < count)
+    {
+    if (time_budget >= 0)
+      {
+      std::chrono::duration<double> elapsed = Clock::now() - start;
+      solver.time_budget = std::max(0.0, time_budget - elapsed.count());
+      }
+    const lbool status = solver.solveLimited(guarded, log);
+    if (status == l_Undef)
+      {
+      Log(log, "search limit reached after %1% alternatives") % result;
+      }
+    if (status != l_True)
+      {
+      break;
+      }
+    ++result;
+    found(solver.model);
+    more = block(solver.model);
+    }
+  solver.releaseVar(~Lit(active));
+  return result;
+  }
+
+} // namespace Karrot
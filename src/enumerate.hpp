@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_ENUMERATE_HPP
+#define KARROT_ENUMERATE_HPP
+
+#include "minisat/Solver.h"
+#include <functional>
+
+namespace Karrot
+{
+
+// Calls 'found' with up to 'count' further models of 'solver' under
+// 'assumptions', in the order the solver finds them, and returns how many
+// there were. The true variables below 'vars' of 'model' and of each model
+// found are blocked, so every model selects a set of these variables that
+// is neither equal to nor a superset of an earlier one.
+//
+// The blocking clauses are guarded by an activation variable. Before
+// returning, the variable is released, which removes the blocking clauses
+// and the clauses learnt from them, so the solver can still be used for
+// other requests and does not grow from call to call. Learnt clauses carry
+// over from one model to the next.
+// 'time_budget' (in seconds, negative for no limit) covers all calls.
+int enumerate(
+    Solver& solver,
+    const vec<Lit>& assumptions,
+    int vars,
+    const vec<lbool>& model,
+    int count,
+    double time_budget,
+    KPrintFun log,
+    const std::function<void(const vec<lbool>&)>& found);
+
+} // namespace Karrot
+
+#endif /* KARROT_ENUMERATE_HPP */
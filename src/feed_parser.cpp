@@ -140,22 +140,45 @@ void FeedParser::parse_build(XmlReader& xml, const std::string& type, const std:
   KImplementation impl(spec.id, this->name, "SOURCE");
   impl.values["href"] = href;
   impl.driver = driver;
+  VariantEnumerator enumerator(variants);
   for (std::size_t i = 0; i < releases.size(); ++i)
     {
     impl.version = releases[i].version();
+    if (!spec.query.evaluate_partial(impl.version, KDictionary()))
+      {
+      continue;
+      }
+    bool nonempty = enumerator.restrict(
+      [&](const std::string& key, const std::string& value) -> bool
+      {
+      KDictionary known;
+      known.insert(std::make_pair(key, value));
+      boost::tribool result = spec.query.evaluate_partial(impl.version, known);
+      return static_cast<bool>(result || boost::indeterminate(result));
+      });
+    if (!nonempty)
+      {
+      continue;
+      }
     impl.values["tag"] = releases[i].tag();
-    foreach_variant(variants, [&](KDictionary variant)
+    // The version is resolved once per release, the variant comes from the
+    // enumerator as quarks.
+    Candidate candidate(impl.version, KDictionary());
+    do
       {
-      if (!spec.query.evaluate(impl.version, variant))
+      const KDictionary& variant = enumerator.current();
+      candidate.variant = enumerator.quarks();
+      if (!spec.query.evaluate(candidate))
         {
-        return;
+        continue;
         }
-      impl.variant = variant;
-      impl.depends.clear();
-      impl.conflicts.clear();
-      depends.replay("*", impl.version, variant, impl.depends, impl.conflicts);
+      impl.variant = intern_variant(variant);
+      auto result = depends.replay("*", impl.version, variant);
+      impl.depends = result->depends;
+      impl.conflicts = result->conflicts;
       db.push_back(impl);
-      });
+      }
+    while (enumerator.next());
     }
   }
 
@@ -335,14 +358,13 @@ void FeedParser::add_package(const Package& package)
         {
         return;
         }
-      for (const Dependencies& component : components)
+      for (Dependencies& component : components)
         {
-        component.replay(
-            impl.component,
-            impl.version,
-            impl.variant,
-            impl.depends,
-            impl.conflicts);
+        if (auto result = component.replay(impl.component, impl.version, *impl.variant))
+          {
+          impl.depends = impl.depends + result->depends;
+          impl.conflicts = impl.conflicts + result->conflicts;
+          }
         }
       }
     this->db.push_back(impl);
@@ -7,20 +7,20 @@
  */
 
 #include "implementation.hpp"
-#include "spec.hpp"
+#include "variants.hpp"
 
 _KImplementation::_KImplementation(
   std::string const& id,
   std::string const& name,
   std::string const& component,
   std::string const& version,
-  KDictionary const& variant,
+  KDictionary const *variant,
   KDictionary const& values)
   : id(id)
   , name(name)
   , component(component)
   , version(version)
-  , variant(variant)
+  , variant(variant ? variant : Karrot::intern_variant(KDictionary()))
   , values(values)
   {
   }
@@ -52,7 +52,7 @@ k_implementation_get_version(KImplementation const *self)
 KDictionary const *
 k_implementation_get_variant(KImplementation const *self)
   {
-  return &self->variant;
+  return self->variant;
   }
 
 KDictionary const *
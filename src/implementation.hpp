@@ -11,11 +11,10 @@
 
 #include <karrot.h>
 #include "dictionary.hpp"
-#include <vector>
+#include "spec.hpp"
 
 namespace Karrot
 {
-class Spec;
 class Driver;
 }
 
@@ -26,16 +25,16 @@ struct _KImplementation
     std::string const& name,
     std::string const& component,
     std::string const& version = std::string(),
-    KDictionary const& variant = KDictionary(),
+    KDictionary const *variant = nullptr,
     KDictionary const& values = KDictionary());
   std::string id;
   std::string name;
   std::string component;
   std::string version;
-  KDictionary variant;
+  KDictionary const *variant; // interned, compare by address
   KDictionary values;
-  std::vector<Karrot::Spec> depends;
-  std::vector<Karrot::Spec> conflicts;
+  Karrot::SpecList depends;
+  Karrot::SpecList conflicts;
   Karrot::Driver const *driver;
   };
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "index.hpp"
+#include "quark.hpp"
+#include <algorithm>
+
+namespace Karrot
+{
+
+ProjectIndex::ProjectIndex(const Database& database, const Candidates& candidates)
+    : candidates(candidates)
+  {
+  const int asterisk = string_to_quark("*");
+  for (std::size_t i = 0; i < database.size(); ++i)
+    {
+    Group& group = projects[database[i].id][database[i].component];
+    if (candidates[i].version == asterisk)
+      {
+      group.wildcards.push_back(i);
+      }
+    else
+      {
+      group.sorted.push_back(i);
+      }
+    }
+  for (auto& project : projects)
+    {
+    for (auto& entry : project.second)
+      {
+      std::vector<int>& sorted = entry.second.sorted;
+      std::stable_sort(sorted.begin(), sorted.end(),
+        [&candidates](int lhs, int rhs) -> bool
+        {
+        return candidates[lhs].version_key < candidates[rhs].version_key;
+        });
+      }
+    }
+  }
+
+void ProjectIndex::query(const Spec& spec, std::vector<int>& result) const
+  {
+  auto project = projects.find(spec.id);
+  if (project == projects.end())
+    {
+    return;
+    }
+  VersionRange range = spec.query.version_range();
+  std::size_t first = result.size();
+  for (auto& entry : project->second)
+    {
+    const std::string& component = entry.first;
+    if (component == spec.component || component == "*" || component == "SOURCE")
+      {
+      query(entry.second, spec, range, result);
+      }
+    }
+  std::sort(result.begin() + first, result.end());
+  }
+
+void ProjectIndex::query(
+    const Group& group,
+    const Spec& spec,
+    const VersionRange& range,
+    std::vector<int>& result) const
+  {
+  auto begin = group.sorted.begin();
+  auto end = group.sorted.end();
+  if (range.empty)
+    {
+    begin = end;
+    }
+  if (range.has_lower)
+    {
+    begin = std::lower_bound(begin, end, range.lower,
+      [this](int index, const VersionKey& key) -> bool
+      {
+      return candidates[index].version_key < key;
+      });
+    }
+  if (range.has_upper)
+    {
+    end = std::upper_bound(begin, end, range.upper,
+      [this](const VersionKey& key, int index) -> bool
+      {
+      return key < candidates[index].version_key;
+      });
+    }
+  for (auto it = begin; it != end; ++it)
+    {
+    if (spec.query.evaluate(candidates[*it]))
+      {
+      result.push_back(*it);
+      }
+    }
+  for (int index : group.wildcards)
+    {
+    if (spec.query.evaluate(candidates[index]))
+      {
+      result.push_back(index);
+      }
+    }
+  }
+
+} // namespace Karrot
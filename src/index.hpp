@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_INDEX_HPP
+#define KARROT_INDEX_HPP
+
+#include "database.hpp"
+#include "spec.hpp"
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace Karrot
+{
+
+// Implementations grouped by project and component, each group sorted by
+// version. A query is answered by a binary search for its version range;
+// the complete query is only evaluated on the implementations in range.
+class ProjectIndex
+  {
+  public:
+    ProjectIndex(const Database& database, const Candidates& candidates);
+    // Appends the indices of all implementations that satisfy 'spec' to
+    // 'result', in ascending order.
+    void query(const Spec& spec, std::vector<int>& result) const;
+  private:
+    class Group
+      {
+      public:
+        std::vector<int> sorted;     // by version key, then by index
+        std::vector<int> wildcards;  // version "*" matches any version
+      };
+    void query(
+        const Group& group,
+        const Spec& spec,
+        const VersionRange& range,
+        std::vector<int>& result) const;
+  private:
+    const Candidates& candidates;
+    std::unordered_map<std::string, std::map<std::string, Group>> projects;
+  };
+
+} // namespace Karrot
+
+#endif /* KARROT_INDEX_HPP */
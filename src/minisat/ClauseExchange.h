@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_CLAUSEEXCHANGE_H
+#define KARROT_CLAUSEEXCHANGE_H
+
+#include "SolverTypes.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Shares learnt clauses between the solvers of a portfolio without locks.
+// Every solver appends to a buffer of its own, which only it writes to, and
+// reads the buffers of all other solvers up to their published size. A full
+// buffer silently drops further clauses.
+class ClauseExchange
+  {
+  public:
+    ClauseExchange(int solvers, int capacity = 1 << 18)
+      {
+      for (int i = 0; i < solvers; ++i)
+        {
+        buffers.emplace_back(new Buffer(capacity));
+        }
+      }
+    int size() const
+      {
+      return buffers.size();
+      }
+    // Called by solver 'from' only.
+    void publish(int from, const vec<Lit>& clause)
+      {
+      Buffer& buffer = *buffers[from];
+      std::size_t end = buffer.size.load(std::memory_order_relaxed);
+      if (end + 1 + clause.size() > buffer.data.size())
+        {
+        return;
+        }
+      buffer.data[end] = clause.size();
+      for (int i = 0; i < clause.size(); ++i)
+        {
+        buffer.data[end + 1 + i] = index(clause[i]);
+        }
+      buffer.size.store(end + 1 + clause.size(), std::memory_order_release);
+      }
+    // Calls 'function(const Lit*, int)' for every clause that another solver
+    // published since the last call by solver 'to'. 'cursors' holds the read
+    // positions of 'to' and must not be shared.
+    template <typename Function>
+    void collect(int to, std::vector<std::size_t>& cursors, Function function)
+      {
+      cursors.resize(buffers.size(), 0);
+      std::vector<Lit> lits;
+      for (std::size_t from = 0; from < buffers.size(); ++from)
+        {
+        if ((int)from == to)
+          {
+          continue;
+          }
+        const Buffer& buffer = *buffers[from];
+        std::size_t end = buffer.size.load(std::memory_order_acquire);
+        std::size_t& i = cursors[from];
+        while (i < end)
+          {
+          int size = buffer.data[i++];
+          lits.clear();
+          for (int k = 0; k < size; ++k)
+            {
+            lits.push_back(toLit(buffer.data[i++]));
+            }
+          function(lits.data(), size);
+          }
+        }
+      }
+  private:
+    class Buffer
+      {
+      public:
+        Buffer(int capacity) : data(capacity), size(0)
+          {
+          }
+        std::vector<int> data;
+        std::atomic<std::size_t> size;
+      };
+    std::vector<std::unique_ptr<Buffer>> buffers;
+  };
+
+#endif /* KARROT_CLAUSEEXCHANGE_H */
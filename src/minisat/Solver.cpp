@@ -25,11 +25,19 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 // Helper functions:
 
 
-bool removeWatch(vec<GClause>& ws, GClause elem)    // Pre-condition: 'elem' must exists in 'ws' OR 'ws' must be empty.
+// Generate a random double in [0, 1) and update the seed (the generator of MiniSat 2):
+static inline double drand(double& seed) {
+    seed *= 1389796;
+    int q = (int)(seed / 2147483647);
+    seed -= (double)q * 2147483647;
+    return seed / 2147483647; }
+
+
+bool removeWatch(vec<Watcher>& ws, GClause elem)    // Pre-condition: 'elem' must exists in 'ws' OR 'ws' must be empty.
 {
     if (ws.size() == 0) return false;     // (skip lists that are already cleared)
     int j = 0;
-    for (; ws[j] != elem  ; j++) assert(j < ws.size());
+    for (; ws[j].clause != elem; j++) assert(j < ws.size());
     for (; j < ws.size()-1; j++) ws[j] = ws[j+1];
     ws.pop();
     return true;
@@ -97,8 +105,8 @@ void Solver::newClause(const vec<Lit>& ps_, bool learnt)
 
     }else if (ps.size() == 2){
         // Create special binary clause watch:
-        watches[index(~ps[0])].push(GClause_new(ps[1]));
-        watches[index(~ps[1])].push(GClause_new(ps[0]));
+        watches[index(~ps[0])].push(Watcher(GClause_new(ps[1]), ps[1]));
+        watches[index(~ps[1])].push(Watcher(GClause_new(ps[0]), ps[0]));
 
         if (learnt){
             check(enqueue(ps[0], GClause_new(~ps[1])));
@@ -109,7 +117,8 @@ void Solver::newClause(const vec<Lit>& ps_, bool learnt)
 
     }else{
         // Allocate clause:
-        Clause* c   = Clause_new(learnt, ps);
+        CRef    cr  = ca.alloc(ps, learnt);
+        Clause& c   = ca[cr];
 
         if (learnt){
             // Put the second watch on the literal with highest decision level:
@@ -119,43 +128,39 @@ void Solver::newClause(const vec<Lit>& ps_, bool learnt)
                 if (level[var(ps[i])] > max)
                     max   = level[var(ps[i])],
                     max_i = i;
-            (*c)[1]     = ps[max_i];
-            (*c)[max_i] = ps[1];
+            c[1]     = ps[max_i];
+            c[max_i] = ps[1];
 
             // Bump, enqueue, store clause:
-            claBumpActivity(c);         // (newly learnt clauses should be considered active)
-            check(enqueue((*c)[0], GClause_new(c)));
-            learnts.push(c);
-            stats.learnts_literals += c->size();
+            claBumpActivity(&c);        // (newly learnt clauses should be considered active)
+            check(enqueue(c[0], GClause_new(cr)));
+            learnts.push(cr);
+            stats.learnts_literals += c.size();
         }else{
             // Store clause:
-            clauses.push(c);
-            stats.clauses_literals += c->size();
+            clauses.push(cr);
+            stats.clauses_literals += c.size();
         }
         // Watch clause:
-        watches[index(~(*c)[0])].push(GClause_new(c));
-        watches[index(~(*c)[1])].push(GClause_new(c));
+        watches[index(~c[0])].push(Watcher(GClause_new(cr), c[1]));
+        watches[index(~c[1])].push(Watcher(GClause_new(cr), c[0]));
     }
 }
 
 
 // Disposes a clauses and removes it from watcher lists. NOTE! Low-level; does NOT change the 'clauses' and 'learnts' vector.
+// The memory is reclaimed by the next 'garbageCollect()'.
 //
-void Solver::remove(Clause* c, bool just_dealloc)
+void Solver::remove(CRef cr)
 {
-    if (!just_dealloc){
-        if (c->size() == 2)
-            removeWatch(watches[index(~(*c)[0])], GClause_new((*c)[1])),
-            removeWatch(watches[index(~(*c)[1])], GClause_new((*c)[0]));
-        else
-            removeWatch(watches[index(~(*c)[0])], GClause_new(c)),
-            removeWatch(watches[index(~(*c)[1])], GClause_new(c));
-    }
+    const Clause& c = ca[cr];
+    removeWatch(watches[index(~c[0])], GClause_new(cr));
+    removeWatch(watches[index(~c[1])], GClause_new(cr));
 
-    if (c->learnt()) stats.learnts_literals -= c->size();
-    else             stats.clauses_literals -= c->size();
+    if (c.learnt()) stats.learnts_literals -= c.size();
+    else            stats.clauses_literals -= c.size();
 
-    xfree(c);
+    ca.free(cr);
 }
 
 
@@ -163,11 +168,11 @@ void Solver::remove(Clause* c, bool just_dealloc)
 // the clause is binary and satisfied, in which case the first literal is true)
 // Returns True if clause is satisfied (will be removed), False otherwise.
 //
-bool Solver::simplify(Clause* c) const
+bool Solver::simplify(const Clause& c) const
 {
     assert(decisionLevel() == 0);
-    for (int i = 0; i < c->size(); i++){
-        if (value((*c)[i]) == l_True)
+    for (int i = 0; i < c.size(); i++){
+        if (value(c[i]) == l_True)
             return true;
     }
     return false;
@@ -181,7 +186,14 @@ bool Solver::simplify(Clause* c) const
 // Creates a new SAT variable in the solver. If 'decision_var' is cleared, variable will not be
 // used as a decision variable (NOTE! This has effects on the meaning of a SATISFIABLE result).
 //
-Var Solver::newVar() {
+Var Solver::newVar(bool dvar) {
+    if (free_vars.size() > 0){
+        Var v = free_vars.last(); free_vars.pop();
+        decision_var [v] = (char)dvar;
+        polarity     [v] = 1;
+        user_polarity[v] = 1;
+        activity     [v] = 0;
+        return v; }
     int     index;
     index = nVars();
     watches     .push();          // (list for positive literal)
@@ -189,11 +201,42 @@ Var Solver::newVar() {
     reason      .push(GClause_NULL);
     assigns     .push(toInt(l_Undef));
     level       .push(-1);
+    decision_var.push((char)dvar);
+    polarity    .push(1);
+    user_polarity.push(1);
     activity    .push(0);
     analyze_seen.push(0);
     return index; }
 
 
+// Gives up a variable that is only used in clauses with 'p', such as the activation literal of a
+// temporary group of clauses. The clauses, including the learnt ones, are satisfied by 'p' and
+// removed at once. Then 'p' is taken off the top-level trail again, so that 'newVar()' can reuse
+// the variable without the solver growing.
+//
+void Solver::releaseVar(Lit p) {
+    assert(decisionLevel() == 0);
+    assert(value(p) != l_False);
+    if (!ok) return;
+    Var v = var(p);
+    if (value(p) == l_Undef)
+        addUnit(p);
+    simpDB_props = 0;
+    simplifyDB();
+    if (!ok) return;
+    int j = 0;
+    for (int i = 0; i < trail.size(); i++)
+        if (var(trail[i]) != v)
+            trail[j++] = trail[i];
+    trail.shrink(trail.size() - j);
+    assigns[v] = toInt(l_Undef);
+    reason [v] = GClause_NULL;
+    level  [v] = -1;
+    qhead          = trail.size();
+    simpDB_assigns = trail.size();
+    free_vars.push(v); }
+
+
 // Returns FALSE if immediate conflict.
 bool Solver::assume(Lit p) {
     trail_lim.push(trail.size());
@@ -207,7 +250,8 @@ void Solver::cancelUntil(int level) {
             Var     x  = var(trail[c]);
             assigns[x] = toInt(l_Undef);
             reason [x] = GClause_NULL;
-            order.undo(x); }
+            if (phase_saving) polarity[x] = sign(trail[c]);
+            if (decision_var[x]) order.undo(x); }
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
         qhead = trail.size(); } }
@@ -234,9 +278,8 @@ void Solver::cancelUntil(int level) {
 |  Effect:
 |    Will undo part of the trail, upto but not beyond the assumption of the current decision level.
 |________________________________________________________________________________________________@*/
-void Solver::analyze(Clause* _confl, vec<Lit>& out_learnt, int& out_btlevel)
+void Solver::analyze(Clause* confl, vec<Lit>& out_learnt, int& out_btlevel)
 {
-    GClause confl = GClause_new(_confl);
     vec<char>&     seen  = analyze_seen;
     int            pathC = 0;
     Lit            p     = lit_Undef;
@@ -247,10 +290,9 @@ void Solver::analyze(Clause* _confl, vec<Lit>& out_learnt, int& out_btlevel)
     out_btlevel = 0;
     int index = trail.size()-1;
     do{
-        assert(confl != GClause_NULL);          // (otherwise should be UIP)
+        assert(confl != NULL);          // (otherwise should be UIP)
 
-        Clause& c = confl.isLit() ? ((*analyze_tmpbin)[1] = confl.lit(), *analyze_tmpbin)
-                                  : *confl.clause();
+        Clause& c = *confl;
         if (c.learnt())
             claBumpActivity(&c);
 
@@ -271,7 +313,10 @@ void Solver::analyze(Clause* _confl, vec<Lit>& out_learnt, int& out_btlevel)
         // Select next clause to look at:
         while (!seen[var(trail[index--])]);
         p     = trail[index+1];
-        confl = reason[var(p)];
+        GClause r = reason[var(p)];
+        confl = r == GClause_NULL ? NULL
+              : r.isLit()         ? ((*analyze_tmpbin)[1] = r.lit(), analyze_tmpbin)
+                                  : ca.lea(r.clause());
         seen[var(p)] = 0;
         pathC--;
 
@@ -303,7 +348,7 @@ void Solver::analyze(Clause* _confl, vec<Lit>& out_learnt, int& out_btlevel)
                 if (!seen[var(q)] && level[var(q)] != 0)
                     out_learnt[j++] = out_learnt[i];
             }else{
-                Clause& c = *r.clause();
+                Clause& c = ca[r.clause()];
                 for (int k = 1; k < c.size(); k++)
                     if (!seen[var(c[k])] && level[var(c[k])] != 0){
                         out_learnt[j++] = out_learnt[i];
@@ -331,7 +376,7 @@ bool Solver::analyze_removable(Lit p, uint min_level)
         assert(reason[var(analyze_stack.last())] != GClause_NULL);
         GClause r = reason[var(analyze_stack.last())]; analyze_stack.pop();
         Clause& c = r.isLit() ? ((*analyze_tmpbin)[1] = r.lit(), *analyze_tmpbin)
-                              : *r.clause();
+                              : ca[r.clause()];
         for (int i = 1; i < c.size(); i++){
             Lit p = c[i];
             if (!analyze_seen[var(p)] && level[var(p)] != 0){
@@ -390,7 +435,7 @@ void Solver::analyzeFinal(Clause* confl, bool skip_first)
                     if (level[var(p)] > 0)
                         seen[var(p)] = 1;
                 }else{
-                    Clause& c = *r.clause();
+                    Clause& c = ca[r.clause()];
                     for (int j = 1; j < c.size(); j++)
                         if (level[var(c[j])] > 0)
                             seen[var(c[j])] = 1;
@@ -451,17 +496,17 @@ Clause* Solver::propagate()
         simpDB_props--;
 
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
-        vec<GClause>&  ws  = watches[index(p)];
-        GClause*       i,* j, *end;
+        vec<Watcher>&  ws  = watches[index(p)];
+        Watcher*       i,* j, *end;
 
-        for (i = j = (GClause*)ws, end = i + ws.size();  i != end;){
-            if (i->isLit()){
-                if (!enqueue(i->lit(), GClause_new(p))){
+        for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+            if (i->clause.isLit()){
+                if (!enqueue(i->clause.lit(), GClause_new(p))){
                     if (decisionLevel() == 0)
                         ok = false;
                     confl = propagate_tmpbin;
                     (*confl)[1] = ~p;
-                    (*confl)[0] = i->lit();
+                    (*confl)[0] = i->clause.lit();
 
                     qhead = trail.size();
                     // Copy the remaining watches:
@@ -469,8 +514,12 @@ Clause* Solver::propagate()
                         *j++ = *i++;
                 }else
                     *j++ = *i++;
+            }else if (value(i->blocker) == l_True){
+                // Clause is satisfied by the blocker, no need to look at it:
+                *j++ = *i++;
             }else{
-                Clause& c = *i->clause(); i++;
+                CRef    cr = i->clause.clause(); i++;
+                Clause& c  = ca[cr];
                 assert(c.size() > 2);
                 // Make sure the false literal is data[1]:
                 Lit false_lit = ~p;
@@ -483,18 +532,18 @@ Clause* Solver::propagate()
                 Lit   first = c[0];
                 lbool val   = value(first);
                 if (val == l_True){
-                    *j++ = GClause_new(&c);
+                    *j++ = Watcher(GClause_new(cr), first);
                 }else{
                     // Look for new watch:
                     for (int k = 2; k < c.size(); k++)
                         if (value(c[k]) != l_False){
                             c[1] = c[k]; c[k] = false_lit;
-                            watches[index(~c[1])].push(GClause_new(&c));
+                            watches[index(~c[1])].push(Watcher(GClause_new(cr), first));
                             goto FoundWatch; }
 
                     // Did not find watch -- clause is unit under assignment:
-                    *j++ = GClause_new(&c);
-                    if (!enqueue(first, GClause_new(&c))){
+                    *j++ = Watcher(GClause_new(cr), first);
+                    if (!enqueue(first, GClause_new(cr))){
                         if (decisionLevel() == 0)
                             ok = false;
                         confl = &c;
@@ -521,27 +570,50 @@ Clause* Solver::propagate()
 |  Description:
 |    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
 |    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|    With 'lbd_reduction', clauses are ranked by their literal block distance first, and clauses
+|    with an LBD of at most 2 ("glue clauses") are never removed either.
 |________________________________________________________________________________________________@*/
-struct reduceDB_lt { bool operator () (Clause* x, Clause* y) { return x->size() > 2 && (y->size() == 2 || x->activity() < y->activity()); } };
+struct reduceDB_lt {
+    const ClauseAllocator& ca;
+    reduceDB_lt(const ClauseAllocator& ca) : ca(ca) {}
+    bool operator () (CRef x, CRef y) { return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); } };
+struct reduceDB_lbd_lt {
+    const ClauseAllocator& ca;
+    reduceDB_lbd_lt(const ClauseAllocator& ca) : ca(ca) {}
+    bool operator () (CRef x, CRef y) { return ca[x].lbd() > ca[y].lbd() || (ca[x].lbd() == ca[y].lbd() && ca[x].activity() < ca[y].activity()); } };
 void Solver::reduceDB()
 {
     int     i, j;
+    if (lbd_reduction){
+        sort(learnts, reduceDB_lbd_lt(ca));
+        for (i = j = 0; i < learnts.size(); i++){
+            if (i < learnts.size() / 2 && ca[learnts[i]].size() > 2 && ca[learnts[i]].lbd() > 2 && !locked(learnts[i]))
+                remove(learnts[i]);
+            else
+                learnts[j++] = learnts[i];
+        }
+        learnts.shrink(i - j);
+        checkGarbage();
+        return;
+    }
+
     double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
 
-    sort(learnts, reduceDB_lt());
+    sort(learnts, reduceDB_lt(ca));
     for (i = j = 0; i < learnts.size() / 2; i++){
-        if (learnts[i]->size() > 2 && !locked(learnts[i]))
+        if (ca[learnts[i]].size() > 2 && !locked(learnts[i]))
             remove(learnts[i]);
         else
             learnts[j++] = learnts[i];
     }
     for (; i < learnts.size(); i++){
-        if (learnts[i]->size() > 2 && !locked(learnts[i]) && learnts[i]->activity() < extra_lim)
+        if (ca[learnts[i]].size() > 2 && !locked(learnts[i]) && ca[learnts[i]].activity() < extra_lim)
             remove(learnts[i]);
         else
             learnts[j++] = learnts[i];
     }
     learnts.shrink(i - j);
+    checkGarbage();
 }
 
 
@@ -568,10 +640,10 @@ void Solver::simplifyDB()
     // Clear watcher lists:
     for (int i = simpDB_assigns; i < nAssigns(); i++){
         Lit           p  = trail[i];
-        vec<GClause>& ws = watches[index(~p)];
+        vec<Watcher>& ws = watches[index(~p)];
         for (int j = 0; j < ws.size(); j++)
-            if (ws[j].isLit())
-                if (removeWatch(watches[index(~ws[j].lit())], GClause_new(p)))  // (remove binary GClause from "other" watcher list)
+            if (ws[j].clause.isLit())
+                if (removeWatch(watches[index(~ws[j].clause.lit())], GClause_new(p)))  // (remove binary GClause from "other" watcher list)
                     n_bin_clauses--;
         watches[index( p)].clear(true);
         watches[index(~p)].clear(true);
@@ -579,16 +651,17 @@ void Solver::simplifyDB()
 
     // Remove satisfied clauses:
     for (int type = 0; type < 2; type++){
-        vec<Clause*>& cs = type ? learnts : clauses;
+        vec<CRef>& cs = type ? learnts : clauses;
         int     j  = 0;
         for (int i = 0; i < cs.size(); i++){
-            if (!locked(cs[i]) && simplify(cs[i]))  // (the test for 'locked()' is currently superfluous, but without it the reason-graph is not correctly maintained for decision level 0)
+            if (!locked(cs[i]) && simplify(ca[cs[i]]))  // (the test for 'locked()' is currently superfluous, but without it the reason-graph is not correctly maintained for decision level 0)
                 remove(cs[i]);
             else
                 cs[j++] = cs[i];
         }
         cs.shrink(cs.size()-j);
     }
+    checkGarbage();
 
     simpDB_assigns = nAssigns();
     simpDB_props   = stats.clauses_literals + stats.learnts_literals;   // (shouldn't depend on 'stats' really, but it will do for now)
@@ -620,6 +693,9 @@ lbool Solver::search(int nof_conflicts, int nof_learnts, const SearchParams& par
     cla_decay = 1 / params.clause_decay;
     model.clear();
 
+    if (exchange != NULL && exchange_import)
+        importClauses();
+
     for (;;){
         Clause* confl = propagate();
         if (confl != NULL){
@@ -633,8 +709,13 @@ lbool Solver::search(int nof_conflicts, int nof_learnts, const SearchParams& par
                 analyzeFinal(confl);
                 return l_False; }
             analyze(confl, learnt_clause, backtrack_level);
+            int lbd = lbd_reduction ? computeLBD(learnt_clause) : 0;
             cancelUntil(std::max(backtrack_level, root_level));
             newClause(learnt_clause, true);
+            stats.learnts++;
+            if (learnt_clause.size() > 2) ca[learnts.last()].lbd() = lbd;
+            if (exchange != NULL && learnt_clause.size() <= exchange_limit)
+                exchange->publish(exchange_id, learnt_clause);
             if (learnt_clause.size() == 1) level[var(learnt_clause[0])] = 0;    // (this is ugly (but needed for 'analyzeFinal()') -- in future versions, we will backtrack past the 'root_level' and redo the assumptions)
             varDecayActivity();
             claDecayActivity();
@@ -642,7 +723,7 @@ lbool Solver::search(int nof_conflicts, int nof_learnts, const SearchParams& par
         }else{
             // NO CONFLICT
 
-            if (nof_conflicts >= 0 && conflictC >= nof_conflicts){
+            if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || interrupted()){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
                 cancelUntil(root_level);
@@ -668,12 +749,139 @@ lbool Solver::search(int nof_conflicts, int nof_learnts, const SearchParams& par
                 return l_True;
             }
 
-            check(assume(~Lit(next)));
+            check(assume(Lit(next, polarity[next])));
         }
     }
 }
 
 
+// Number of distinct decision levels among the literals of 'lits' (the "literal block distance"
+// of Audemard and Simon, 2009). Clauses with a small LBD connect few decisions and tend to stay useful.
+//
+int Solver::computeLBD(const vec<Lit>& lits)
+{
+    lbd_stamp.growTo(decisionLevel() + 1, 0);
+    lbd_counter++;
+    int lbd = 0;
+    for (int i = 0; i < lits.size(); i++){
+        int l = level[var(lits[i])];
+        if (lbd_stamp[l] != lbd_counter){
+            lbd_stamp[l] = lbd_counter;
+            lbd++; }
+    }
+    return lbd;
+}
+
+
+// Finite subsequences of the Luby-sequence: 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+//
+static double luby(double y, int x)
+{
+    int size, seq;
+    for (size = 1, seq = 0; size < x+1; seq++, size = 2*size+1);
+    while (size-1 != x){
+        size = (size-1)>>1;
+        seq--;
+        x = x % size; }
+    return pow(y, seq);
+}
+
+
+// Adds the clauses that the other solvers of the portfolio have published since the last call.
+// Must be called at the root level.
+//
+void Solver::importClauses()
+{
+    assert(decisionLevel() == root_level);
+    exchange->collect(exchange_id, import_cursors,
+        [this](const Lit* lits, int size) { importClause(lits, size); });
+}
+
+
+// Clauses learnt by another solver are implied by the problem clauses, but may be unit or false
+// under the current assignment (which contains the assumptions). The watches go to non-false
+// literals first, then to the false literal of the highest level. Clauses that are false under the
+// assumptions are skipped; this solver will find the conflict by itself.
+//
+struct importClause_lt {
+    const Solver& s; const vec<int>& level;
+    importClause_lt(const Solver& s, const vec<int>& level) : s(s), level(level) {}
+    bool operator () (Lit x, Lit y) {
+        bool fx = s.value(x) == l_False, fy = s.value(y) == l_False;
+        return fx != fy ? fy : fx && level[var(x)] > level[var(y)]; } };
+void Solver::importClause(const Lit* lits, int size)
+{
+    if (!ok) return;
+
+    vec<Lit>& ps = import_tmp;
+    ps.clear();
+    for (int i = 0; i < size; i++){
+        if (value(lits[i]) == l_True && level[var(lits[i])] == 0)
+            return;
+        if (value(lits[i]) != l_False || level[var(lits[i])] != 0)
+            ps.push(lits[i]);
+    }
+    if (ps.size() == 0)
+        return;
+    sort(ps, importClause_lt(*this, level));
+    if (value(ps[0]) == l_False)
+        return;
+
+    if (ps.size() == 1){
+        if (value(ps[0]) == l_Undef){
+            check(enqueue(ps[0]));
+            level[var(ps[0])] = 0; }     // (the same hack as for learnt unit clauses in 'search()')
+        return; }
+
+    bool unit = value(ps[0]) == l_Undef && value(ps[1]) == l_False;
+    if (ps.size() == 2){
+        watches[index(~ps[0])].push(Watcher(GClause_new(ps[1]), ps[1]));
+        watches[index(~ps[1])].push(Watcher(GClause_new(ps[0]), ps[0]));
+        stats.learnts_literals += ps.size();
+        n_bin_clauses++;
+        if (unit) check(enqueue(ps[0], GClause_new(~ps[1])));
+    }else{
+        CRef    cr = ca.alloc(ps, true);
+        Clause& c  = ca[cr];
+        c.lbd() = c.size();
+        claBumpActivity(&c);
+        learnts.push(cr);
+        stats.learnts_literals += c.size();
+        watches[index(~c[0])].push(Watcher(GClause_new(cr), c[1]));
+        watches[index(~c[1])].push(Watcher(GClause_new(cr), c[0]));
+        if (unit) check(enqueue(c[0], GClause_new(cr)));
+    }
+}
+
+
+// Exports the assignments at decision level 0 as unit clauses, followed by at most 'max_count' learnt
+// clauses of up to 'max_size' literals, shortest and most active first. Learnt binary clauses are
+// not distinguishable from problem clauses and are left out.
+//
+struct learntClauses_lt {
+    const ClauseAllocator& ca;
+    learntClauses_lt(const ClauseAllocator& ca) : ca(ca) {}
+    bool operator () (CRef x, CRef y) { return ca[x].size() < ca[y].size() || (ca[x].size() == ca[y].size() && ca[x].activity() > ca[y].activity()); } };
+void Solver::learntClauses(int max_size, int max_count, std::vector<std::vector<Lit> >& out)
+{
+    int     units = trail_lim.size() == 0 ? trail.size() : trail_lim[0];
+    for (int i = 0; i < units; i++)
+        out.push_back(std::vector<Lit>(1, trail[i]));
+
+    vec<CRef>   candidates;
+    for (int i = 0; i < learnts.size(); i++)
+        if (ca[learnts[i]].size() <= max_size)
+            candidates.push(learnts[i]);
+    sort(candidates, learntClauses_lt(ca));
+    for (int i = 0; i < candidates.size() && i < max_count; i++){
+        const Clause& c = ca[candidates[i]];
+        out.push_back(std::vector<Lit>());
+        for (int j = 0; j < c.size(); j++)
+            out.back().push_back(c[j]);
+    }
+}
+
+
 // Return search-space coverage. Not extremely reliable.
 //
 double Solver::progressEstimate()
@@ -702,11 +910,61 @@ void Solver::varRescaleActivity()
 void Solver::claRescaleActivity()
 {
     for (int i = 0; i < learnts.size(); i++)
-        learnts[i]->activity() *= 1e-20f;
+        ca[learnts[i]].activity() *= 1e-20f;
     cla_inc *= 1e-20;
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  garbageCollect : ()  ->  [void]
+|
+|  Description:
+|    Removed clauses are only marked as wasted memory in 'ca'. Once too much of it is wasted, all live
+|    clauses are copied into a new, compact region and every reference to them (watcher lists,
+|    reasons, 'clauses' and 'learnts') is updated. The old region is released.
+|________________________________________________________________________________________________@*/
+void Solver::checkGarbage()
+{
+    if (ca.wasted() > ca.size() * garbage_frac)
+        garbageCollect();
+}
+
+void Solver::garbageCollect()
+{
+    ClauseAllocator to(ca.size() - ca.wasted());
+    relocAll(to);
+    to.moveTo(ca);
+}
+
+void Solver::relocAll(ClauseAllocator& to)
+{
+    // All watchers:
+    for (int i = 0; i < watches.size(); i++){
+        vec<Watcher>& ws = watches[i];
+        for (int j = 0; j < ws.size(); j++)
+            if (!ws[j].clause.isLit()){
+                CRef cr = ws[j].clause.clause();
+                ca.reloc(cr, to);
+                ws[j].clause = GClause_new(cr); }
+    }
+
+    // All reasons:
+    for (int i = 0; i < trail.size(); i++){
+        Var     x = var(trail[i]);
+        GClause r = reason[x];
+        if (r != GClause_NULL && !r.isLit()){
+            CRef cr = r.clause();
+            ca.reloc(cr, to);
+            reason[x] = GClause_new(cr); }
+    }
+
+    // All clauses:
+    for (int i = 0; i < learnts.size(); i++) ca.reloc(learnts[i], to);
+    for (int i = 0; i < clauses.size(); i++) ca.reloc(clauses[i], to);
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  solve : (assumps : const vec<Lit>&)  ->  [bool]
@@ -716,15 +974,10 @@ void Solver::claRescaleActivity()
 |    'simplifyDB()' first to see that no top-level conflict is present (which would put the solver
 |    in an undefined state).
 |________________________________________________________________________________________________@*/
-bool Solver::solve(const vec<Lit>& assumps, KPrintFun log)
+lbool Solver::solveLimited(const vec<Lit>& assumps, KPrintFun log)
 {
     simplifyDB();
-    if (!ok) return false;
-
-    SearchParams    params(default_params);
-    double  nof_conflicts = 100;
-    double  nof_learnts   = nClauses() / 3;
-    lbool   status        = l_Undef;
+    if (!ok) return l_False;
 
     // Perform assumptions:
     root_level = assumps.size();
@@ -740,35 +993,93 @@ bool Solver::solve(const vec<Lit>& assumps, KPrintFun log)
                     (*confl)[1] = ~p;
                     (*confl)[0] = r.lit();
                 }else
-                    confl = r.clause();
+                    confl = ca.lea(r.clause());
                 analyzeFinal(confl, true);
                 conflict.push(~p);
             }else
                 conflict.clear(),
                 conflict.push(~p);
             cancelUntil(0);
-            return false; }
+            return l_False; }
         Clause* confl = propagate();
         if (confl != NULL){
             analyzeFinal(confl), assert(conflict.size() > 0);
             cancelUntil(0);
-            return false; }
+            return l_False; }
     }
     assert(root_level == decisionLevel());
 
     // Search:
+    conflict_limit = stats.conflicts + conflict_budget;
+    if (time_budget >= 0)
+        deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_budget));
+    SearchParams    params(default_params);
+    for (int i = 0; i < nVars(); i++) polarity[i] = user_polarity[i];
+    if (dynamic_order && random_seed != 0 && stats.starts == 0)
+        for (int i = 0; i < nVars(); i++)
+            activity[i] = drand(random_seed) * 0.00001;
+    order.setDynamic(dynamic_order);
+    lbool   status = solveLoop(params, log);
+
+    if (status == l_True && dynamic_order){
+        // The dynamic search only proves satisfiability. Find the model again with the classic
+        // heuristics in static preference order, which yields the least model in that order no
+        // matter which clauses were learnt (see VarOrder), so that the result does not depend on
+        // the search heuristics. All learnt clauses are kept, which makes this second search cheap.
+        bool    saved_phase_saving  = phase_saving;
+        bool    saved_luby_restarts = luby_restarts;
+        bool    saved_lbd_reduction = lbd_reduction;
+        phase_saving = luby_restarts = lbd_reduction = false;
+        for (int i = 0; i < nVars(); i++) polarity[i] = user_polarity[i];
+        order.setDynamic(false);
+        status = solveLoop(params, log);
+        phase_saving  = saved_phase_saving;
+        luby_restarts = saved_luby_restarts;
+        lbd_reduction = saved_lbd_reduction;
+    }
+
+    cancelUntil(0);
+    return status;
+}
+
+
+// TRUE if the search should give up: the interrupt flag is set, or a resource limit is exceeded.
+//
+bool Solver::interrupted() const
+{
+    if (interrupt != NULL && interrupt->load(std::memory_order_relaxed))
+        return true;
+    if (conflict_budget >= 0 && stats.conflicts >= conflict_limit)
+        return true;
+    return time_budget >= 0 && std::chrono::steady_clock::now() >= deadline;
+}
+
+
+// The restart loop of 'solve()'. Returns 'l_Undef' only if interrupted.
+//
+lbool Solver::solveLoop(const SearchParams& params, KPrintFun log)
+{
+    double  nof_conflicts = 100;
+    double  nof_learnts   = nClauses() / 3;
+    lbool   status        = l_Undef;
+    int     restarts      = 0;
+
     if (verbosity >= 1){
         log("==================================[MINISAT]===================================");
         log("| Conflicts |     ORIGINAL     |              LEARNT              | Progress |");
         log("|           | Clauses Literals |   Limit Clauses Literals  Lit/Cl |          |");
         log("==============================================================================");
     }
-    while (status == l_Undef){
+    while (status == l_Undef && !interrupted()){
         if (verbosity >= 1){
             char buffer[80];
             sprintf(buffer, "| %9d | %7d %8d | %7d %7d %8d %7.1f | %6.3f %% |", (int)stats.conflicts, nClauses(), (int)stats.clauses_literals, (int)nof_learnts, nLearnts(), (int)stats.learnts_literals, (double)stats.learnts_literals/nLearnts(), progress_estimate*100);
             log(buffer);
         }
+        if (progress)
+            progress(stats);
+        if (luby_restarts)
+            nof_conflicts = 100 * luby(2, restarts++);
         status = search((int)nof_conflicts, (int)nof_learnts, params);
         nof_conflicts *= 1.5;
         nof_learnts   *= 1.1;
@@ -776,6 +1087,5 @@ bool Solver::solve(const vec<Lit>& assumps, KPrintFun log)
     if (verbosity >= 1)
         log("==============================================================================");
 
-    cancelUntil(0);
-    return status == l_True;
+    return status;
 }
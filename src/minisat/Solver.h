@@ -20,19 +20,23 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Solver_h
 #define Solver_h
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <vector>
 #include <karrot.h>
 #include "SolverTypes.h"
 #include "VarOrder.h"
+#include "ClauseExchange.h"
 
 //=================================================================================================
 // Solver -- the main class:
 
 
 struct SolverStats {
-    int64   starts, decisions, propagations, conflicts;
+    int64   starts, decisions, propagations, conflicts, learnts;
     int64   clauses_literals, learnts_literals, max_literals, tot_literals;
-    SolverStats() : starts(0), decisions(0), propagations(0), conflicts(0)
+    SolverStats() : starts(0), decisions(0), propagations(0), conflicts(0), learnts(0)
       , clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0) { }
 };
 
@@ -49,8 +53,9 @@ protected:
     // Solver state:
     //
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
-    vec<Clause*>        clauses;          // List of problem clauses.
-    vec<Clause*>        learnts;          // List of learnt clauses.
+    ClauseAllocator     ca;               // Holds all problem and learnt clauses of size > 2.
+    vec<CRef>           clauses;          // List of problem clauses.
+    vec<CRef>           learnts;          // List of learnt clauses.
     int                 n_bin_clauses;    // Keep track of number of binary clauses "inlined" into the watcher lists (we do this primarily to get identical behavior to the version without the binary clauses trick).
     double              cla_inc;          // Amount to bump next clause with.
     double              cla_decay;        // INVERSE decay factor for clause activity: stores 1/decay.
@@ -60,16 +65,22 @@ protected:
     double              var_decay;        // INVERSE decay factor for variable activity: stores 1/decay. Use negative value for static variable order.
     VarOrder            order;            // Keeps track of the decision variable order.
 
-    vec<vec<GClause> >  watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    vec<vec<Watcher> >  watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
     vec<char>           assigns;          // The current assignments (lbool:s stored as char:s).
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<GClause>        reason;           // 'reason[var]' is the clause that implied the variables current value, or 'NULL' if none.
     vec<int>            level;            // 'level[var]' is the decision level at which assignment was made.
+    vec<char>           decision_var;     // 'decision_var[var]' is TRUE if the variable may be picked by the decision heuristic.
+    vec<char>           polarity;         // The phase to decide each variable on (TRUE means negative). Changes only with 'phase_saving'.
+    vec<char>           user_polarity;    // The phase that 'polarity' starts from in each search, see 'setPolarity()'.
+    vec<Var>            free_vars;        // Variables given up by 'releaseVar()', which 'newVar()' hands out again.
     int                 root_level;       // Level of first proper decision.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplifyDB()'.
     int64               simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplifyDB()'.
+    int64               conflict_limit;   // 'stats.conflicts' at which the current call of 'solveLimited()' gives up (see 'conflict_budget').
+    std::chrono::steady_clock::time_point deadline; // Time at which the current call of 'solveLimited()' gives up (see 'time_budget').
 
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which is used:
     //
@@ -81,6 +92,10 @@ protected:
     Clause*             solve_tmpunit;
     vec<Lit>            addBinary_tmp;
     vec<Lit>            addTernary_tmp;
+    vec<int>            lbd_stamp;
+    int                 lbd_counter;
+    vec<Lit>            import_tmp;
+    std::vector<std::size_t> import_cursors;
 
     // Main internal methods:
     //
@@ -91,11 +106,19 @@ protected:
     void        analyze          (Clause* confl, vec<Lit>& out_learnt, int& out_btlevel); // (bt = backtrack)
     bool        analyze_removable(Lit p, uint min_level);                                 // (helper method for 'analyze()')
     void        analyzeFinal     (Clause* confl,  bool skip_first = false);
-    bool        enqueue          (Lit fact, GClause from = GClause_new((Clause*)NULL));
+    bool        enqueue          (Lit fact, GClause from = GClause_NULL);
     Clause*     propagate        ();
     void        reduceDB         ();
     Lit         pickBranchLit    (const SearchParams& params);
     lbool       search           (int nof_conflicts, int nof_learnts, const SearchParams& params);
+    lbool       solveLoop        (const SearchParams& params, KPrintFun log);
+    int         computeLBD       (const vec<Lit>& lits);
+    void        importClauses    ();
+    void        importClause     (const Lit* lits, int size);
+    bool        interrupted      () const;
+    void        checkGarbage     ();
+    void        garbageCollect   ();
+    void        relocAll         (ClauseAllocator& to);
     double      progressEstimate ();
 
     // Activity:
@@ -103,7 +126,7 @@ protected:
     void     varBumpActivity(Lit p) {
         if (var_decay < 0) return;     // (negative decay means static variable order -- don't bump)
         if ( (activity[var(p)] += var_inc) > 1e100 ) varRescaleActivity();
-        /*order.update(var(p));*/ }
+        order.update(var(p)); }
     void     varDecayActivity  () { if (var_decay >= 0) var_inc *= var_decay; }
     void     varRescaleActivity();
     void     claDecayActivity  () { cla_inc *= cla_decay; }
@@ -113,9 +136,9 @@ protected:
     //
     void     newClause(const vec<Lit>& ps, bool learnt = false);
     void     claBumpActivity (Clause* c) { if ( (c->activity() += (float)cla_inc) > 1e20f ) claRescaleActivity(); }
-    void     remove          (Clause* c, bool just_dealloc = false);
-    bool     locked          (const Clause* c) const { GClause r = reason[var((*c)[0])]; return !r.isLit() && r.clause() == c; }
-    bool     simplify        (Clause* c) const;
+    void     remove          (CRef cr);
+    bool     locked          (CRef cr) const { GClause r = reason[var(ca[cr][0])]; return !r.isLit() && r.clause() == cr; }
+    bool     simplify        (const Clause& c) const;
 
     int      decisionLevel() const { return trail_lim.size(); }
 
@@ -127,13 +150,27 @@ public:
              , cla_decay        (1)
              , var_inc          (1)
              , var_decay        (1)
-             , order            (assigns, std::move(preferences))
+             , order            (assigns, activity, std::move(preferences))
              , qhead            (0)
              , simpDB_assigns   (0)
              , simpDB_props     (0)
+             , conflict_limit   (0)
              , default_params   (SearchParams(0.95, 0.999, 0.02))
              , expensive_ccmin  (true)
              , verbosity        (0)
+             , garbage_frac     (0.20)
+             , dynamic_order    (false)
+             , phase_saving     (false)
+             , luby_restarts    (false)
+             , lbd_reduction    (false)
+             , random_seed      (0)
+             , exchange         (NULL)
+             , exchange_id      (0)
+             , exchange_import  (true)
+             , exchange_limit   (8)
+             , interrupt        (NULL)
+             , conflict_budget  (-1)
+             , time_budget      (-1)
              , progress_estimate(0)
              {
                 vec<Lit> dummy(2,lit_Undef);
@@ -143,11 +180,13 @@ public:
                 solve_tmpunit    = Clause_new(false, dummy);
                 addBinary_tmp .growTo(2);
                 addTernary_tmp.growTo(3);
+                lbd_counter = 0;
              }
 
    ~Solver() {
-       for (int i = 0; i < learnts.size(); i++) remove(learnts[i], true);
-       for (int i = 0; i < clauses.size(); i++) if (clauses[i] != NULL) remove(clauses[i], true); }
+       xfree(propagate_tmpbin);
+       xfree(analyze_tmpbin);
+       xfree(solve_tmpunit); }
 
     // Helpers: (semi-internal)
     //
@@ -167,22 +206,54 @@ public:
     SearchParams    default_params;     // Restart frequency etc.
     bool            expensive_ccmin;    // Controls conflict clause minimization. TRUE by default.
     int             verbosity;          // Verbosity level. 0=silent, 1=some progress report, 2=everything
+    double          garbage_frac;       // Compact the clause memory when this fraction of it is wasted. 0.20 by default.
+
+    // Modern search: (all FALSE by default, which gives the classic MiniSat 1.14 behavior)
+    //
+    bool            dynamic_order;      // Decide by VSIDS activity; the preference order only breaks ties. A satisfiable result is
+                                        // recomputed in static preference order, keeping the learnt clauses.
+    bool            phase_saving;       // Decide on the last value of a variable instead of always on FALSE.
+    bool            luby_restarts;      // Restart after 100 * luby(i) conflicts instead of a geometric series.
+    bool            lbd_reduction;      // Rank learnt clauses by literal block distance; clauses with LBD <= 2 are kept.
+    double          random_seed;        // If not 0, the initial activities are randomized with this seed (dynamic order only).
+
+    // Portfolio: (see 'ClauseExchange')
+    //
+    ClauseExchange* exchange;           // If not NULL, short learnt clauses are shared with other solvers through this object.
+    int             exchange_id;        // The buffer of this solver in 'exchange'.
+    bool            exchange_import;    // Add the clauses learnt by other solvers at each restart. TRUE by default.
+    int             exchange_limit;     // Only learnt clauses up to this size are published. 8 by default.
+    const std::atomic<bool>* interrupt; // If not NULL, the search gives up as soon as this flag is set.
+
+    // Resource limits: (per call of 'solveLimited()'; the search gives up with 'l_Undef' when one is exceeded)
+    //
+    int64           conflict_budget;    // Maximal number of conflicts. Negative (default) for no limit.
+    double          time_budget;        // Maximal number of seconds. Negative (default) for no limit.
+
+    // Monitoring:
+    //
+    std::function<void(const SolverStats&)> progress; // If set, called before each restart with the current statistics.
 
     // Problem specification:
     //
-    Var     newVar    ();
+    Var     newVar    (bool decision_var = true);
     int     nVars     ()                    { return assigns.size(); }
     void    addUnit   (Lit p)               { if (ok) ok = enqueue(p); }
     void    addBinary (Lit p, Lit q)        { addBinary_tmp [0] = p; addBinary_tmp [1] = q; addClause(addBinary_tmp); }
     void    addTernary(Lit p, Lit q, Lit r) { addTernary_tmp[0] = p; addTernary_tmp[1] = q; addTernary_tmp[2] = r; addClause(addTernary_tmp); }
     void    addClause (const vec<Lit>& ps)  { newClause(ps); }  // (used to be a difference between internal and external method...)
+    void    addLearnt (const vec<Lit>& ps)  { importClause(ps, ps.size()); }   // A clause implied by the others, e.g. learnt in an earlier run.
+    void    setPolarity(Var v, bool s)      { user_polarity[v] = (char)s; }    // Decide 'v' on 'Lit(v, s)' first. By default, all variables are decided FALSE.
+    void    releaseVar(Lit p);                  // Makes 'p' true for good and removes all clauses with 'p', after which 'var(p)' is reused. No clause may contain '~p'.
 
     // Solving:
     //
     bool    okay() { return ok; }       // FALSE means solver is in an conflicting state (must never be used again!)
     void    simplifyDB();
-    bool    solve(const vec<Lit>& assumps, KPrintFun log);
+    lbool   solveLimited(const vec<Lit>& assumps, KPrintFun log);   // 'l_Undef' if interrupted or out of budget.
+    bool    solve(const vec<Lit>& assumps, KPrintFun log) { return solveLimited(assumps, log) == l_True; }
     bool    solve(KPrintFun log) { vec<Lit> tmp; return solve(tmp, log); }
+    void    learntClauses(int max_size, int max_count, std::vector<std::vector<Lit> >& out);    // Top-level facts and the shortest, most active learnt clauses.
 
     double      progress_estimate;  // Set by 'search()'.
     vec<lbool>  model;              // If problem is satisfiable, this vector contains the model (if any).
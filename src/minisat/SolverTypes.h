@@ -52,6 +52,7 @@ public:
     friend Lit  id    (Lit p, bool sgn);
 
     friend bool operator == (Lit p, Lit q);
+    friend bool operator != (Lit p, Lit q);
     friend bool operator <  (Lit p, Lit q);
 
     uint hash() const { return (uint)x; }
@@ -64,6 +65,7 @@ inline Lit  toLit (int i) { Lit p; p.x = i; return p; }  // Inverse of 'index()'
 inline Lit  unsign(Lit p) { Lit q; q.x = p.x & ~1; return q; }
 inline Lit  id    (Lit p, bool sgn) { Lit q; q.x = p.x ^ (int)sgn; return q; }
 inline bool operator == (Lit p, Lit q) { return index(p) == index(q); }
+inline bool operator != (Lit p, Lit q) { return index(p) != index(q); }
 inline bool operator <  (Lit p, Lit q) { return index(p)  < index(q); }  // '<' guarantees that p, ~p are adjacent in the ordering.
 
 const Lit lit_Undef(var_Undef, false);  // }- Useful special constants.
@@ -77,53 +79,141 @@ inline int toDimacs(Lit p) { return sign(p) ? -var(p) - 1 : var(p) + 1; }
 
 
 class Clause {
-    uint    size_learnt;
+    uint    header;     // size << 2 | reloced << 1 | learnt
     Lit     data[1];
 public:
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     Clause(bool learnt, const vec<Lit>& ps) {
-        size_learnt = (ps.size() << 1) | (int)learnt;
+        header = (ps.size() << 2) | (int)learnt;
         for (int i = 0; i < ps.size(); i++) data[i] = ps[i];
-        if (learnt) activity() = 0; }
+        if (learnt) activity() = 0, lbd() = 0; }
 
     // -- use this function instead:
     friend Clause* Clause_new(bool learnt, const vec<Lit>& ps);
 
-    int       size        ()      const { return size_learnt >> 1; }
-    bool      learnt      ()      const { return size_learnt & 1; }
+    int       size        ()      const { return header >> 2; }
+    bool      learnt      ()      const { return header & 1; }
     Lit       operator [] (int i) const { return data[i]; }
     Lit&      operator [] (int i)       { return data[i]; }
     float&    activity    ()      const { return *((float*)&data[size()]); }
+    uint&     lbd         ()      const { return *((uint*)&data[size()+1]); }   // (learnt clauses only: literal block distance)
+
+    // Number of 32-bit words occupied by a clause:
+    static int words(int size, bool learnt) { return 1 + size + 2*(int)learnt; }
+    int        words()            const { return words(size(), learnt()); }
+
+    // Forwarding during garbage collection (see 'ClauseAllocator::reloc()'):
+    bool      reloced     ()      const { return header & 2; }
+    uint      relocation  ()      const { return (uint)index(data[0]); }
+    void      relocate    (uint c)      { header |= 2; data[0] = toLit((int)c); }
 };
 inline Clause* Clause_new(bool learnt, const vec<Lit>& ps) {
     assert(sizeof(Lit)      == sizeof(uint));
     assert(sizeof(float)    == sizeof(uint));
-    void*   mem = xmalloc<char>(sizeof(Clause) - sizeof(Lit) + sizeof(uint)*(ps.size() + (int)learnt));
+    void*   mem = xmalloc<char>(sizeof(uint)*Clause::words(ps.size(), learnt));
     return new (mem) Clause(learnt, ps); }
 
 
+//=================================================================================================
+// ClauseAllocator -- a region of memory holding all clauses of a solver:
+
+
+// Clauses are referred to by their 32-bit offset into the region. Freed clauses are only counted as
+// wasted; the space is reclaimed by copying all live clauses into a new region ('reloc()').
+typedef uint CRef;
+const CRef CRef_Undef = 0x7FFFFFFF;
+
+class ClauseAllocator {
+    uint*   memory;
+    uint    sz;
+    uint    cap;
+    uint    wasted_;
+
+    void    grow(uint min_cap) {
+        if (min_cap <= cap) return;
+        assert(min_cap < CRef_Undef);
+        if (cap == 0) cap = 1024;
+        while (cap < min_cap) cap += (cap >> 1) + 8;
+        memory = xrealloc(memory, cap); }
+
+    // Don't allow copying (error prone):
+    ClauseAllocator& operator = (ClauseAllocator& other); // = delete;
+                     ClauseAllocator(ClauseAllocator& other); // = delete;
+
+public:
+    ClauseAllocator(uint capacity = 0) : memory(NULL), sz(0), cap(0), wasted_(0) { grow(capacity); }
+   ~ClauseAllocator() { xfree(memory); }
+
+    CRef alloc(const vec<Lit>& ps, bool learnt) {
+        CRef    cr = sz;
+        grow(sz + Clause::words(ps.size(), learnt));
+        sz += Clause::words(ps.size(), learnt);
+        new (&memory[cr]) Clause(learnt, ps);
+        return cr; }
+    void free(CRef cr) { wasted_ += (*this)[cr].words(); }
+
+    Clause&       operator [] (CRef cr)       { return *(Clause*)&memory[cr]; }
+    const Clause& operator [] (CRef cr) const { return *(const Clause*)&memory[cr]; }
+    Clause*       lea         (CRef cr)       { return (Clause*)&memory[cr]; }
+
+    uint    size  () const { return sz; }
+    uint    wasted() const { return wasted_; }
+
+    // Copies the clause 'cr' into 'to' (only once) and updates 'cr' to its new location:
+    void reloc(CRef& cr, ClauseAllocator& to) {
+        Clause& c = (*this)[cr];
+        if (c.reloced()){ cr = c.relocation(); return; }
+        CRef    nr = to.sz;
+        to.grow(to.sz + c.words());
+        to.sz += c.words();
+        for (int i = 0; i < c.words(); i++) to.memory[nr + i] = memory[cr + i];
+        c.relocate(nr);
+        cr = nr; }
+
+    // Hands the memory over to 'to', releasing the memory previously held by 'to':
+    void moveTo(ClauseAllocator& to) {
+        xfree(to.memory);
+        to.memory = memory; to.sz = sz; to.cap = cap; to.wasted_ = wasted_;
+        memory = NULL; sz = cap = wasted_ = 0; }
+};
+
+
 //=================================================================================================
 // GClause -- Generalize clause:
 
 
-// Either a pointer to a clause or a literal.
+// Either a reference to a clause or a literal.
 class GClause {
-    void*   data;
-    GClause(void* d) : data(d) {}
+    uint    data;
+    GClause(uint d) : data(d) {}
 public:
     friend GClause GClause_new(Lit p);
-    friend GClause GClause_new(Clause* c);
+    friend GClause GClause_new(CRef c);
 
-    bool        isLit    () const { return ((uintp)data & 1) == 1; }
-    Lit         lit      () const { return toLit(((intp)data) >> 1); }
-    Clause*     clause   () const { return (Clause*)data; }
+    bool        isLit    () const { return (data & 1) == 1; }
+    Lit         lit      () const { return toLit((int)(data >> 1)); }
+    CRef        clause   () const { return data >> 1; }
     bool        operator == (GClause c) const { return data == c.data; }
     bool        operator != (GClause c) const { return data != c.data; }
 };
-inline GClause GClause_new(Lit p)     { return GClause((void*)(((intp)index(p) << 1) + 1)); }
-inline GClause GClause_new(Clause* c) { assert(((uintp)c & 1) == 0); return GClause((void*)c); }
+inline GClause GClause_new(Lit p)  { return GClause(((uint)index(p) << 1) + 1); }
+inline GClause GClause_new(CRef c) { assert(c <= CRef_Undef); return GClause(c << 1); }
+
+#define GClause_NULL GClause_new(CRef_Undef)
+
 
-#define GClause_NULL GClause_new((Clause*)NULL)
+//=================================================================================================
+// Watcher -- an entry of a watcher list:
+
+
+// For clauses of size > 2, 'blocker' is some literal of the clause; if it is true, the clause is
+// satisfied and need not be visited. For binary clauses, 'blocker' is the other literal.
+struct Watcher {
+    GClause clause;
+    Lit     blocker;
+    Watcher() : clause(GClause_NULL) {}
+    Watcher(GClause c, Lit b) : clause(c), blocker(b) {}
+};
 
 
 //=================================================================================================
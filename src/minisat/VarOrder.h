@@ -12,24 +12,91 @@
 #include "SolverTypes.h"
 #include <vector>
 
+// Decision order. By default, variables are decided in the static order of
+// the preference stack (last element first): the next decision is always the
+// unassigned variable of highest rank, no matter in which order variables
+// were assigned and undone. With a fixed polarity, the first model found is
+// therefore the least one in that order, whatever clauses were learnt. In
+// dynamic mode, variables are kept in a binary heap ordered by VSIDS
+// activity, and ties are broken by the position in the preference stack.
 class VarOrder
   {
   public:
-    VarOrder(const vec<char>& assigns, std::vector<Var>&& preferences)
-        : assigns(assigns), preferences(std::move(preferences))
+    VarOrder(const vec<char>& assigns, const vec<double>& activity, std::vector<Var>&& preferences)
+        : assigns(assigns), activity(activity), preferences(std::move(preferences)), dynamic(false)
       {
+      cursor = (int)this->preferences.size() - 1;
+      for (std::size_t i = 0; i < this->preferences.size(); ++i)
+        {
+        Var x = this->preferences[i];
+        if (x >= (Var)rank.size())
+          {
+          rank.resize(x + 1, -1);
+          }
+        rank[x] = i;
+        }
       }
   public:
+    // Switches between the static preference stack and the activity heap.
+    // Either way, all preference variables become candidates again.
+    void setDynamic(bool enable)
+      {
+      dynamic = enable;
+      heap.clear();
+      indices.assign(rank.size(), -1);
+      cursor = (int)preferences.size() - 1;
+      if (dynamic)
+        {
+        for (std::size_t i = preferences.size(); i-- > 0;)
+          {
+          insert(preferences[i]);
+          }
+        }
+      }
+    bool isDynamic() const
+      {
+      return dynamic;
+      }
     void undo(Var x)
       {
-      preferences.push_back(x);
+      if (!dynamic)
+        {
+        if (x < (Var)rank.size() && rank[x] > cursor)
+          {
+          cursor = rank[x];
+          }
+        }
+      else if (!inHeap(x))
+        {
+        insert(x);
+        }
+      }
+    // Called when the activity of 'x' was increased.
+    void update(Var x)
+      {
+      if (dynamic && inHeap(x))
+        {
+        up(indices[x]);
+        }
       }
     Var select()
       {
-      while (!preferences.empty())
+      if (dynamic)
+        {
+        while (!heap.empty())
+          {
+          Var next = removeMax();
+          if (toLbool(assigns[next]) == l_Undef)
+            {
+            return next;
+            }
+          }
+        return var_Undef;
+        }
+      // Every variable ranked above the cursor is assigned.
+      for (; cursor >= 0; --cursor)
         {
-        Var next = preferences.back();
-        preferences.pop_back();
+        Var next = preferences[cursor];
         if (toLbool(assigns[next]) == l_Undef)
           {
           return next;
@@ -37,9 +104,85 @@ class VarOrder
         }
       return var_Undef;
       }
+  private:
+    bool before(Var x, Var y) const
+      {
+      if (activity[x] != activity[y])
+        {
+        return activity[x] > activity[y];
+        }
+      return rank[x] > rank[y];
+      }
+    bool inHeap(Var x) const
+      {
+      return x < (Var)indices.size() && indices[x] >= 0;
+      }
+    void insert(Var x)
+      {
+      if (x >= (Var)rank.size() || rank[x] < 0)
+        {
+        return;
+        }
+      indices[x] = heap.size();
+      heap.push_back(x);
+      up(indices[x]);
+      }
+    Var removeMax()
+      {
+      Var x = heap[0];
+      heap[0] = heap.back();
+      indices[heap[0]] = 0;
+      indices[x] = -1;
+      heap.pop_back();
+      if (heap.size() > 1)
+        {
+        down(0);
+        }
+      return x;
+      }
+    void up(int i)
+      {
+      Var x = heap[i];
+      while (i > 0 && before(x, heap[(i - 1) / 2]))
+        {
+        heap[i] = heap[(i - 1) / 2];
+        indices[heap[i]] = i;
+        i = (i - 1) / 2;
+        }
+      heap[i] = x;
+      indices[x] = i;
+      }
+    void down(int i)
+      {
+      Var x = heap[i];
+      const int size = heap.size();
+      while (2 * i + 1 < size)
+        {
+        int child = 2 * i + 1;
+        if (child + 1 < size && before(heap[child + 1], heap[child]))
+          {
+          ++child;
+          }
+        if (!before(heap[child], x))
+          {
+          break;
+          }
+        heap[i] = heap[child];
+        indices[heap[i]] = i;
+        i = child;
+        }
+      heap[i] = x;
+      indices[x] = i;
+      }
   private:
     const vec<char>& assigns;
+    const vec<double>& activity;
     std::vector<Var> preferences;
+    std::vector<int> rank;     // position in the preference stack, -1 if none
+    int cursor;                // rank of the next static decision candidate
+    std::vector<Var> heap;
+    std::vector<int> indices;  // position in the heap, -1 if not contained
+    bool dynamic;
 };
 
 #endif /* KARROT_VARORDER_H */
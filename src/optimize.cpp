@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "optimize.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace Karrot
+{
+
+typedef std::chrono::steady_clock Clock;
+
+// Sequential weighted counter (Hoelldobler, Manthey and Steinke, 2012).
+// After each variable, register j is true if the variables so far weigh at
+// least j + 1, saturating at 'limit'. Only this direction is encoded, which
+// is all an upper bound needs. The registers are never decided on; left
+// unassigned, they count as false. The counter takes O(n * limit) variables
+// and clauses, so minimize() passes weights divided by their greatest
+// common divisor and the cost of the first model as the limit.
+class Counter
+  {
+  public:
+    Counter(Solver& solver, const std::vector<int>& weights, int limit)
+      {
+      for (Var v = 0; v < (Var)weights.size(); ++v)
+        {
+        const int weight = weights[v];
+        if (weight <= 0)
+          {
+          continue;
+          }
+        const int size = std::min<int>(limit, registers.size() + weight);
+        std::vector<Var> next(size);
+        for (Var& r : next)
+          {
+          r = solver.newVar(false);
+          }
+        for (int j = 0; j < std::min(weight, size); ++j)
+          {
+          solver.addBinary(~Lit(v), Lit(next[j]));
+          }
+        for (int j = 0; j < (int)registers.size(); ++j)
+          {
+          solver.addBinary(~Lit(registers[j]), Lit(next[j]));
+          const int k = std::min(j + weight, limit - 1);
+          solver.addTernary(~Lit(v), ~Lit(registers[j]), Lit(next[k]));
+          }
+        registers.swap(next);
+        }
+      }
+    // The literal that limits the sum to 'bound', which must be less than
+    // the limit.
+    Lit atMost(int bound) const
+      {
+      return ~Lit(registers[bound]);
+      }
+  private:
+    std::vector<Var> registers;
+  };
+
+static int gcd(int a, int b)
+  {
+  while (b != 0)
+    {
+    const int r = a % b;
+    a = b;
+    b = r;
+    }
+  return a;
+  }
+
+// The positive weights divided by their greatest common divisor, which is
+// returned as 'unit'. Other weights become 0, the counter ignores them.
+static std::vector<int> scale(const std::vector<int>& weights, int& unit)
+  {
+  unit = 0;
+  for (int weight : weights)
+    {
+    unit = gcd(unit, std::max(weight, 0));
+    }
+  unit = std::max(unit, 1);
+  std::vector<int> result;
+  for (int weight : weights)
+    {
+    result.push_back(std::max(weight, 0) / unit);
+    }
+  return result;
+  }
+
+static int cost(const std::vector<int>& weights, const vec<lbool>& model)
+  {
+  int result = 0;
+  for (Var v = 0; v < (Var)weights.size(); ++v)
+    {
+    if (model[v] == l_True)
+      {
+      result += weights[v];
+      }
+    }
+  return result;
+  }
+
+lbool minimize(
+    Solver& solver,
+    const vec<Lit>& assumptions,
+    const std::vector<int>& weights,
+    double time_budget,
+    KPrintFun log,
+    vec<lbool>& model,
+    bool& optimal)
+  {
+  const Clock::time_point start = Clock::now();
+  auto remaining = [&]() -> double
+    {
+    if (time_budget < 0)
+      {
+      return -1;
+      }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    return std::max(0.0, time_budget - elapsed.count());
+    };
+
+  optimal = false;
+  solver.time_budget = remaining();
+  lbool status = solver.solveLimited(assumptions, log);
+  if (status != l_True)
+    {
+    return status;
+    }
+  solver.model.copyTo(model);
+  int unit;
+  const std::vector<int> scaled = scale(weights, unit);
+  int best = cost(scaled, model);
+  int lower = 0;
+  Log(log, "first model costs %1%") % cost(weights, model);
+  if (best > 0)
+    {
+    // Binary search, with the bound as an assumption, so that it can be
+    // lifted again after an unsatisfiable call.
+    Counter counter(solver, scaled, best);
+    vec<Lit> bounded;
+    assumptions.copyTo(bounded);
+    bounded.push(lit_Undef);
+    while (lower < best)
+      {
+      const int bound = lower + (best - lower) / 2;
+      bounded.last() = counter.atMost(bound);
+      solver.time_budget = remaining();
+      status = solver.solveLimited(bounded, log);
+      if (status == l_Undef)
+        {
+        break;
+        }
+      if (status == l_False)
+        {
+        lower = bound + 1;
+        continue;
+        }
+      solver.model.copyTo(model);
+      best = cost(scaled, model);
+      Log(log, "found a model that costs %1%") % cost(weights, model);
+      }
+    }
+  optimal = lower == best;
+  if (optimal)
+    {
+    Log(log, "the model is optimal at cost %1%") % cost(weights, model);
+    }
+  else
+    {
+    Log(log, "search limit reached, the best model costs %1%") % cost(weights, model);
+    }
+  return l_True;
+  }
+
+} // namespace Karrot
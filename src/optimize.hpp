@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_OPTIMIZE_HPP
+#define KARROT_OPTIMIZE_HPP
+
+#include "minisat/Solver.h"
+#include <vector>
+
+namespace Karrot
+{
+
+// Minimizes the sum of 'weights[v]' over all variables 'v' that are true,
+// by a binary search over upper bounds on the sum. The bounds are given by a
+// weighted counter, which is added to 'solver' after the first model.
+//
+// 'time_budget' (in seconds, negative for no limit) covers all calls, while
+// the conflict budget of the solver applies to each call. If the budget runs
+// out after a model was found, the best model so far is returned with
+// 'l_True' and 'optimal' is false.
+lbool minimize(
+    Solver& solver,
+    const vec<Lit>& assumptions,
+    const std::vector<int>& weights,
+    double time_budget,
+    KPrintFun log,
+    vec<lbool>& model,
+    bool& optimal);
+
+} // namespace Karrot
+
+#endif /* KARROT_OPTIMIZE_HPP */
@@ -10,6 +10,7 @@
 #define KARROT_PACKAGE_HPP
 
 #include "dictionary.hpp"
+#include "variants.hpp"
 
 namespace Karrot
 {
@@ -19,13 +20,13 @@ class Driver;
 class Package
   {
   public:
-    Package() : driver(nullptr)
+    Package() : variant(intern_variant(KDictionary())), driver(nullptr)
       {
       }
   public:
     std::string component;
     std::string version;
-    KDictionary variant;
+    const KDictionary* variant;
     KDictionary values;
     KDictionary fields;
     Driver const *driver;
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "portfolio.hpp"
+#include "log.hpp"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace Karrot
+{
+
+void load(const Formula& formula, Solver& solver)
+  {
+  for (int i = 0; i < formula.nVars(); ++i)
+    {
+    solver.newVar(formula.decision(i));
+    }
+  for (const std::vector<Lit>& lits : formula.clauses)
+    {
+    vec<Lit> clause;
+    for (Lit p : lits)
+      {
+      clause.push(p);
+      }
+    solver.addClause(clause);
+    }
+  }
+
+// Solver 0 is the classic search. The others alternate restart policy and
+// phase saving, and from the third one on, start from random activities.
+static void configure(Solver& solver, int number)
+  {
+  if (number == 0)
+    {
+    solver.exchange_import = false;
+    return;
+    }
+  solver.dynamic_order = true;
+  solver.lbd_reduction = true;
+  solver.luby_restarts = number % 2 == 1;
+  solver.phase_saving = (number / 2) % 2 == 0;
+  solver.random_seed = number > 2 ? 91648253 + number : 0;
+  }
+
+lbool solve_portfolio(
+    const Formula& formula,
+    const std::vector<Var>& preferences,
+    const vec<Lit>& assumptions,
+    int solvers,
+    int64 conflict_budget,
+    double time_budget,
+    const std::function<void(const SolverStats&)>& progress,
+    KPrintFun log,
+    vec<lbool>& model,
+    SolverStats& stats)
+  {
+  ClauseExchange exchange(solvers);
+  std::atomic<bool> done(false);
+  std::atomic<int> winner(-1);
+  std::vector<std::unique_ptr<Solver>> instances;
+  std::vector<lbool> results(solvers, l_Undef);
+  std::vector<std::exception_ptr> errors(solvers);
+  for (int i = 0; i < solvers; ++i)
+    {
+    instances.emplace_back(new Solver(std::vector<Var>(preferences)));
+    Solver& solver = *instances.back();
+    configure(solver, i);
+    solver.exchange = &exchange;
+    solver.exchange_id = i;
+    solver.interrupt = &done;
+    solver.conflict_budget = conflict_budget;
+    solver.time_budget = time_budget;
+    }
+  instances[0]->progress = progress;
+
+  auto work = [&](int i)
+    {
+    try
+      {
+      Solver& solver = *instances[i];
+      load(formula, solver);
+      results[i] = solver.solveLimited(assumptions, log);
+      }
+    catch (...)
+      {
+      errors[i] = std::current_exception();
+      }
+    if (results[i] != l_Undef || errors[i])
+      {
+      int none = -1;
+      winner.compare_exchange_strong(none, i);
+      done = true;
+      }
+    };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < solvers; ++i)
+    {
+    threads.emplace_back(work, i);
+    }
+  work(0);
+  for (std::thread& thread : threads)
+    {
+    thread.join();
+    }
+
+  for (const std::unique_ptr<Solver>& instance : instances)
+    {
+    stats.starts += instance->stats.starts;
+    stats.decisions += instance->stats.decisions;
+    stats.propagations += instance->stats.propagations;
+    stats.conflicts += instance->stats.conflicts;
+    stats.learnts += instance->stats.learnts;
+    }
+  const int i = winner;
+  if (i < 0)
+    {
+    log("all portfolio solvers ran out of budget");
+    return l_Undef;
+    }
+  if (errors[i])
+    {
+    std::rethrow_exception(errors[i]);
+    }
+  Log(log, "portfolio solver %1% of %2% finished first") % i % solvers;
+  if (results[i] == l_True)
+    {
+    instances[i]->model.copyTo(model);
+    }
+  return results[i];
+  }
+
+} // namespace Karrot
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_PORTFOLIO_HPP
+#define KARROT_PORTFOLIO_HPP
+
+#include "simplify.hpp"
+#include "minisat/Solver.h"
+#include <functional>
+#include <vector>
+
+namespace Karrot
+{
+
+void load(const Formula& formula, Solver& solver);
+
+// Solves 'formula' under 'assumptions' with 'solvers' differently configured
+// solvers on separate threads, which share their short learnt clauses. The
+// result of the first one to finish is returned.
+//
+// The first solver uses the classic search and does not import clauses. The
+// other solvers search by activity and recompute a satisfying model in
+// static preference order before they finish (see Solver::dynamic_order).
+// The static order yields the least model in preference order, whatever
+// clauses were learnt or imported (see VarOrder), so the model does not
+// depend on which solver wins and equals the one of a single solver.
+//
+// The budgets apply to each solver (see Solver::conflict_budget). If all of
+// them run out, the result is 'l_Undef'. 'stats' receives the sum of the
+// statistics of all solvers. Only the first solver, which runs on the calling
+// thread, reports its 'progress'.
+lbool solve_portfolio(
+    const Formula& formula,
+    const std::vector<Var>& preferences,
+    const vec<Lit>& assumptions,
+    int solvers,
+    int64 conflict_budget,
+    double time_budget,
+    const std::function<void(const SolverStats&)>& progress,
+    KPrintFun log,
+    vec<lbool>& model,
+    SolverStats& stats);
+
+} // namespace Karrot
+
+#endif /* KARROT_PORTFOLIO_HPP */
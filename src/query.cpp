@@ -23,7 +23,7 @@ static const int OR            = -10;
 #include "quark.hpp"
 #include "vercmp.hpp"
 #include "variants.hpp"
-#include <iostream>
+#include <algorithm>
 #include <sstream>
 
 namespace Karrot
@@ -75,33 +75,86 @@ static inline bool is_ident(int id)
   return id >= 0;
   }
 
-static inline int get_variant(const KDictionary& variants, int key)
+static void unknown_variable(const Candidate& candidate, int key)
   {
-  auto it = variants.find(quark_to_string(key));
-  if (it != variants.end())
-    {
-    return to_quark(it->second);
-    }
   std::stringstream message;
   message
     << "Unknown variable '"
     << quark_to_string(key)
     << "' used in test. Known variables are: "
     ;
-  for (auto& entry : variants)
+  for (auto& entry : candidate.variant)
     {
-    message << "'" << entry.first << "', ";
+    message << "'" << quark_to_string(entry.first) << "', ";
     }
   message << "and 'version'.";
   throw std::runtime_error(message.str());
   }
 
+// Returns the value of 'key' in the candidate or -1 if it is not set.
+static inline int lookup(const Candidate& candidate, int key)
+  {
+  for (auto& entry : candidate.variant)
+    {
+    if (entry.first == key)
+      {
+      return entry.second;
+      }
+    }
+  return -1;
+  }
+
+static int apply(int op, int diff)
+  {
+  switch (op)
+    {
+    case LESS:
+      return diff < 0;
+    case LESS_EQUAL:
+      return diff <= 0;
+    case GREATER:
+      return diff > 0;
+    case GREATER_EQUAL:
+      return diff >= 0;
+    }
+  return 0;
+  }
+
+static int apply(int op, int op1, int op2)
+  {
+  switch (op)
+    {
+    case LESS:
+    case LESS_EQUAL:
+    case GREATER:
+    case GREATER_EQUAL:
+      return apply(op, vercmp(quark_to_string(op1), quark_to_string(op2)));
+    case NOT_EQUAL:
+      return op1 != op2 && op1 != ASTERISK && op2 != ASTERISK;
+    case EQUAL:
+      return op1 == op2 || op1 == ASTERISK || op2 == ASTERISK;
+    }
+  return 0;
+  }
+
+Candidate::Candidate(const std::string& version, const KDictionary& variant)
+  : version(to_quark(version))
+  , version_key(version.c_str())
+  {
+  this->variant.reserve(variant.size());
+  for (auto& entry : variant)
+    {
+    this->variant.emplace_back(to_quark(entry.first), to_quark(entry.second));
+    }
+  }
+
 Query::Query(const std::string& string)
   {
   if (string.empty())
     {
     return;
     }
+  std::vector<int> queryspace;
   std::string::const_iterator strpos = string.begin();
   std::string::const_iterator strend = string.end();
 
@@ -191,84 +244,258 @@ Query::Query(const std::string& string)
     queryspace.push_back(sc);
     --sl;
     }
+  compile(queryspace);
   }
 
+// Translate the postfix token sequence into a program in which every test is
+// a single instruction with its variable and constant already resolved.
+void Query::compile(const std::vector<int>& queryspace)
+  {
+  std::vector<int> stack; // operands; -1 denotes a computed value
+  std::size_t depth = 0;
+  for (int c : queryspace)
+    {
+    if (is_ident(c))
+      {
+      stack.push_back(c);
+      continue;
+      }
+    if (stack.size() < 2)
+      {
+      throw std::runtime_error("Query: insufficient values in the expression");
+      }
+    int op2 = stack.back();
+    stack.pop_back();
+    int op1 = stack.back();
+    stack.pop_back();
+    Instruction instruction;
+    instruction.op = c;
+    instruction.lhs = op1;
+    instruction.rhs = op2;
+    if (c == AND || c == OR ? is_ident(op1) || is_ident(op2) : !is_ident(op1) || !is_ident(op2))
+      {
+      throw std::runtime_error("Query: invalid expression");
+      }
+    if (!is_relation(c) && c != EQUAL && c != NOT_EQUAL)
+      {
+      instruction.lhs = instruction.rhs = 0;
+      }
+    if ((is_relation(c) || c == EQUAL) && op1 == VERSION)
+      {
+      instruction.rhs_key = VersionKey(quark_to_string(op2));
+      }
+    program.push_back(instruction);
+    stack.push_back(-1);
+    depth = std::max(depth, stack.size());
+    }
+  if (stack.size() != 1)
+    {
+    throw std::runtime_error("Query: invalid expression");
+    }
+  if (is_ident(stack[0]))
+    {
+    // a lone identifier is always true
+    program.clear();
+    }
+  if (depth > max_depth)
+    {
+    throw std::runtime_error("Query: expression too complex");
+    }
+  }
 
-bool Query::evaluate(const std::string& version, const KDictionary& variants) const
+bool Query::evaluate(const Candidate& candidate) const
   {
-  if (queryspace.empty())
+  if (program.empty())
     {
     return true;
     }
 
-  // TODO: change to use std::vector/std::array
-  unsigned int stack[32];
+  bool stack[max_depth];
   unsigned int sl = 0; // stack length
 
-  for(int c : queryspace)
+  for (const Instruction& instruction : program)
     {
-    if (is_ident(c))
-      {
-      stack[sl++] = c;
-      }
-    else if (is_operator(c))
+    switch (instruction.op)
       {
-      if (sl < 2)
-        {
-        std::cout << "(Error) insufficient values in the expression." << std::endl;
-        return false;
-        }
-      int op2 = stack[--sl];
-      int op1 = stack[--sl];
-      int diff, res;
-      if (op1 == VERSION)
-        {
-        op1 = to_quark(version);
-        }
-      else if (op1 > 1) // 1 == true!
-        {
-        op1 = get_variant(variants, op1);
-        }
-      if (is_relation(c))
+      case AND:
+        --sl;
+        stack[sl - 1] = stack[sl - 1] && stack[sl];
+        break;
+      case OR:
+        --sl;
+        stack[sl - 1] = stack[sl - 1] || stack[sl];
+        break;
+      default:
         {
-        diff = vercmp(quark_to_string(op1), quark_to_string(op2));
-        }
-      switch (c)
-        {
-        case LESS:
-          res = diff < 0;
-          break;
-        case LESS_EQUAL:
-          res = diff <= 0;
-          break;
-        case GREATER:
-          res = diff > 0;
-          break;
-        case GREATER_EQUAL:
-          res = diff >= 0;
-          break;
-        case NOT_EQUAL:
-          res = op1 != op2 && op1 != ASTERISK && op2 != ASTERISK;
-          break;
-        case EQUAL:
-          res = op1 == op2 || op1 == ASTERISK || op2 == ASTERISK;
-          break;
-        case AND:
-          res = op1 && op2;
-          break;
-        case OR:
-          res = op1 || op2;
+        if (instruction.lhs == VERSION && is_relation(instruction.op))
+          {
+          int diff = candidate.version_key.compare(instruction.rhs_key);
+          stack[sl++] = apply(instruction.op, diff) != 0;
           break;
+          }
+        int value = candidate.version;
+        if (instruction.lhs != VERSION)
+          {
+          value = lookup(candidate, instruction.lhs);
+          if (value < 0)
+            {
+            unknown_variable(candidate, instruction.lhs);
+            }
+          }
+        stack[sl++] = apply(instruction.op, value, instruction.rhs) != 0;
         }
-      stack[sl++] = res;
+        break;
+      }
+    }
+  return stack[0];
+  }
+
+bool Query::evaluate(const std::string& version, const KDictionary& variants) const
+  {
+  if (program.empty())
+    {
+    return true;
+    }
+  return evaluate(Candidate(version, variants));
+  }
+
+// Same as 'evaluate', but variables that are missing in 'variants' are not an
+// error. Every test that involves them is indeterminate, and so is the result
+// unless the known tests decide it. This is used to prune variant combinations
+// before they are enumerated.
+boost::tribool Query::evaluate_partial(const std::string& version, const KDictionary& variants) const
+  {
+  if (program.empty())
+    {
+    return true;
+    }
+
+  boost::tribool stack[max_depth];
+  unsigned int sl = 0; // stack length
+
+  for (const Instruction& instruction : program)
+    {
+    switch (instruction.op)
+      {
+      case AND:
+        --sl;
+        stack[sl - 1] = stack[sl - 1] && stack[sl];
+        break;
+      case OR:
+        --sl;
+        stack[sl - 1] = stack[sl - 1] || stack[sl];
+        break;
+      default:
+        if (instruction.lhs == VERSION)
+          {
+          stack[sl++] = apply(instruction.op, to_quark(version), instruction.rhs) != 0;
+          break;
+          }
+        auto it = variants.find(quark_to_string(instruction.lhs));
+        if (it == variants.end())
+          {
+          stack[sl++] = boost::indeterminate;
+          }
+        else
+          {
+          stack[sl++] = apply(instruction.op, to_quark(it->second), instruction.rhs) != 0;
+          }
+        break;
       }
     }
-  if (sl != 1)
+  return stack[0];
+  }
+
+static VersionRange intersect(const VersionRange& lhs, const VersionRange& rhs)
+  {
+  VersionRange result = lhs;
+  if (rhs.has_lower && (!result.has_lower || result.lower < rhs.lower))
+    {
+    result.has_lower = true;
+    result.lower = rhs.lower;
+    }
+  if (rhs.has_upper && (!result.has_upper || rhs.upper < result.upper))
+    {
+    result.has_upper = true;
+    result.upper = rhs.upper;
+    }
+  result.empty = lhs.empty || rhs.empty
+      || (result.has_lower && result.has_upper && result.upper < result.lower);
+  return result;
+  }
+
+static VersionRange hull(const VersionRange& lhs, const VersionRange& rhs)
+  {
+  if (lhs.empty)
+    {
+    return rhs;
+    }
+  if (rhs.empty)
+    {
+    return lhs;
+    }
+  VersionRange result = lhs;
+  result.has_lower = lhs.has_lower && rhs.has_lower;
+  if (result.has_lower && rhs.lower < lhs.lower)
+    {
+    result.lower = rhs.lower;
+    }
+  result.has_upper = lhs.has_upper && rhs.has_upper;
+  if (result.has_upper && lhs.upper < rhs.upper)
+    {
+    result.upper = rhs.upper;
+    }
+  return result;
+  }
+
+// Derive the range of versions that may satisfy the query. Strict relations
+// are widened to inclusive bounds, disjunctions to the hull of both ranges,
+// and tests that do not constrain the version to the unbounded range.
+VersionRange Query::version_range() const
+  {
+  VersionRange stack[max_depth];
+  unsigned int sl = 0; // stack length
+
+  for (const Instruction& instruction : program)
     {
-    std::cout << "ERROR: " << sl << " elements left on the stack!" << std::endl;
-    return false;
+    VersionRange range;
+    switch (instruction.op)
+      {
+      case AND:
+        --sl;
+        stack[sl - 1] = intersect(stack[sl - 1], stack[sl]);
+        continue;
+      case OR:
+        --sl;
+        stack[sl - 1] = hull(stack[sl - 1], stack[sl]);
+        continue;
+      case LESS:
+      case LESS_EQUAL:
+        if (instruction.lhs == VERSION)
+          {
+          range.has_upper = true;
+          range.upper = instruction.rhs_key;
+          }
+        break;
+      case GREATER:
+      case GREATER_EQUAL:
+        if (instruction.lhs == VERSION)
+          {
+          range.has_lower = true;
+          range.lower = instruction.rhs_key;
+          }
+        break;
+      case EQUAL:
+        if (instruction.lhs == VERSION && instruction.rhs != ASTERISK)
+          {
+          range.has_lower = range.has_upper = true;
+          range.lower = range.upper = instruction.rhs_key;
+          }
+        break;
+      }
+    stack[sl++] = range;
     }
-  return stack[0] != 0;
+  return sl == 1 ? stack[0] : VersionRange();
   }
 
 } // namespace Karrot
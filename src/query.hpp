@@ -9,21 +9,77 @@
 #ifndef KARROT_QUERY_HPP
 #define KARROT_QUERY_HPP
 
-#include <karrot.h>
+#include "dictionary.hpp"
+#include "vercmp.hpp"
+#include <boost/logic/tribool.hpp>
 #include <string>
 #include <vector>
 
 namespace Karrot
 {
 
+// The properties of an implementation that a query can test, resolved to
+// quarks once. Evaluating a query against a candidate does no hashing, no
+// map lookups and no string work.
+class Candidate
+  {
+  public:
+    Candidate(const std::string& version, const KDictionary& variant);
+  public:
+    int version;
+    VersionKey version_key;
+    std::vector<std::pair<int, int>> variant; // key, value
+  };
+
+typedef std::vector<Candidate> Candidates;
+
+// An inclusive interval of versions. A query's range contains at least every
+// version for which the query can be true, but it may contain more.
+class VersionRange
+  {
+  public:
+    VersionRange() : empty(false), has_lower(false), has_upper(false)
+      {
+      }
+    bool contains(const VersionKey& key) const
+      {
+      return !empty
+          && (!has_lower || !(key < lower))
+          && (!has_upper || !(upper < key));
+      }
+  public:
+    bool empty;
+    bool has_lower;
+    bool has_upper;
+    VersionKey lower;
+    VersionKey upper;
+  };
+
 class Query
   {
   public:
     Query() = default;
     Query(const std::string& string);
+    bool evaluate(const Candidate& candidate) const;
     bool evaluate(const std::string& version, const KDictionary& variants) const;
+    boost::tribool evaluate_partial(const std::string& version, const KDictionary& variants) const;
+    VersionRange version_range() const;
+  private:
+    void compile(const std::vector<int>& queryspace);
   private:
-    std::vector<int> queryspace;
+    // Either a test that compares variable 'lhs' with constant 'rhs', or a
+    // logical operator that combines the two topmost results. Relational
+    // and equality tests of the version use the pre-parsed 'rhs_key'.
+    class Instruction
+      {
+      public:
+        int op;
+        int lhs;
+        int rhs;
+        VersionKey rhs_key;
+      };
+    static const std::size_t max_depth = 32;
+    std::vector<Instruction> program;
   };
 
 } // namespace Karrot
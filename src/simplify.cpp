@@ -0,0 +1,585 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "simplify.hpp"
+#include <algorithm>
+
+namespace Karrot
+{
+
+// Variable elimination is skipped if it would have to consider more pairs
+// of clauses than this.
+static const std::size_t max_resolvents = 4096;
+
+static std::uint64_t abstraction(const std::vector<Lit>& lits)
+  {
+  std::uint64_t result = 0;
+  for (Lit p : lits)
+    {
+    result |= std::uint64_t(1) << (var(p) & 63);
+    }
+  return result;
+  }
+
+// Sorts and deduplicates 'lits'. Returns false if they form a tautology.
+static bool normalize(std::vector<Lit>& lits)
+  {
+  std::sort(lits.begin(), lits.end());
+  lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+  for (std::size_t i = 1; i < lits.size(); ++i)
+    {
+    if (lits[i] == ~lits[i - 1])
+      {
+      return false;
+      }
+    }
+  return true;
+  }
+
+// Returns lit_Undef if 'c' subsumes 'd', a literal p of 'c' if 'c' subsumes
+// 'd' except that 'd' contains ~p, and lit_Error otherwise. Both clauses are
+// sorted, so the two literals of a variable are adjacent.
+static Lit subsumes(const std::vector<Lit>& c, const std::vector<Lit>& d)
+  {
+  Lit flip = lit_Undef;
+  std::size_t k = 0;
+  for (Lit p : c)
+    {
+    while (k < d.size() && var(d[k]) < var(p))
+      {
+      ++k;
+      }
+    if (k == d.size() || var(d[k]) != var(p))
+      {
+      return lit_Error;
+      }
+    if (d[k] != p)
+      {
+      if (flip != lit_Undef)
+        {
+        return lit_Error;
+        }
+      flip = p;
+      }
+    ++k;
+    }
+  return flip;
+  }
+
+// Resolves 'c' and 'd' on 'pivot', which occurs in 'c' while ~pivot occurs
+// in 'd'. Returns false if the resolvent is a tautology.
+static bool resolve(
+    const std::vector<Lit>& c,
+    const std::vector<Lit>& d,
+    Lit pivot,
+    std::vector<Lit>& result)
+  {
+  result.clear();
+  for (Lit p : c)
+    {
+    if (p != pivot)
+      {
+      result.push_back(p);
+      }
+    }
+  for (Lit p : d)
+    {
+    if (p != ~pivot)
+      {
+      result.push_back(p);
+      }
+    }
+  return normalize(result);
+  }
+
+static void erase(std::vector<int>& list, int row)
+  {
+  list.erase(std::find(list.begin(), list.end(), row));
+  }
+
+Simplifier::Simplifier(Formula& formula, const std::vector<bool>& frozen)
+    : formula(formula)
+    , frozen(frozen)
+    , eliminated(formula.nVars(), false)
+    , assigns(formula.nVars(), 0)
+    , head(0)
+    , occurs(2 * formula.nVars())
+  {
+  this->frozen.resize(formula.nVars(), false);
+  }
+
+bool Simplifier::simplify()
+  {
+  for (const std::vector<Lit>& clause : formula.clauses)
+    {
+    if (!add(clause))
+      {
+      return false;
+      }
+    }
+  if (!propagate() || !substitute() || !propagate())
+    {
+    return false;
+    }
+  std::vector<int> all;
+  for (std::size_t row = 0; row < rows.size(); ++row)
+    {
+    all.push_back(row);
+    }
+  if (!subsume(std::move(all)) || !eliminate())
+    {
+    return false;
+    }
+  formula.clauses.clear();
+  for (Lit p : trail)
+    {
+    formula.addUnit(p);
+    }
+  for (const Row& row : rows)
+    {
+    if (!row.removed)
+      {
+      formula.clauses.push_back(row.lits);
+      }
+    }
+  return true;
+  }
+
+void Simplifier::extend(vec<lbool>& model) const
+  {
+  std::size_t i = stack.size();
+  while (i > 0)
+    {
+    const std::size_t size = index(stack[--i]);
+    i -= size;
+    const Lit pivot = stack[i];
+    bool satisfied = false;
+    for (std::size_t k = i + 1; k < i + size && !satisfied; ++k)
+      {
+      // Unassigned variables count as false, so '~v' is satisfied.
+      const bool value = model[var(stack[k])] == l_True;
+      satisfied = value != sign(stack[k]);
+      }
+    if (!satisfied)
+      {
+      model[var(pivot)] = sign(pivot) ? l_False : l_True;
+      }
+    }
+  }
+
+lbool Simplifier::value(Lit p) const
+  {
+  lbool value = toLbool(assigns[var(p)]);
+  return sign(p) ? ~value : value;
+  }
+
+bool Simplifier::assign(Lit p)
+  {
+  if (value(p) != l_Undef)
+    {
+    return value(p) == l_True;
+    }
+  assigns[var(p)] = sign(p) ? -1 : 1;
+  trail.push_back(p);
+  return true;
+  }
+
+bool Simplifier::add(std::vector<Lit> lits)
+  {
+  if (!normalize(lits))
+    {
+    return true;
+    }
+  std::size_t size = 0;
+  for (Lit p : lits)
+    {
+    if (value(p) == l_True)
+      {
+      return true;
+      }
+    if (value(p) == l_Undef)
+      {
+      lits[size++] = p;
+      }
+    }
+  lits.resize(size);
+  if (lits.empty())
+    {
+    return false;
+    }
+  if (lits.size() == 1)
+    {
+    return assign(lits[0]);
+    }
+  const int row = rows.size();
+  for (Lit p : lits)
+    {
+    occurs[index(p)].push_back(row);
+    }
+  rows.push_back(Row{std::move(lits), 0, false});
+  rows.back().abstraction = abstraction(rows.back().lits);
+  touched.push_back(row);
+  return true;
+  }
+
+void Simplifier::remove(int row)
+  {
+  rows[row].removed = true;
+  for (Lit p : rows[row].lits)
+    {
+    erase(occurs[index(p)], row);
+    }
+  }
+
+bool Simplifier::strengthen(int row, Lit p)
+  {
+  std::vector<Lit>& lits = rows[row].lits;
+  lits.erase(std::find(lits.begin(), lits.end(), p));
+  erase(occurs[index(p)], row);
+  if (lits.size() == 1)
+    {
+    Lit unit = lits[0];
+    remove(row);
+    return assign(unit);
+    }
+  rows[row].abstraction = abstraction(lits);
+  touched.push_back(row);
+  return true;
+  }
+
+bool Simplifier::propagate()
+  {
+  while (head < trail.size())
+    {
+    const Lit p = trail[head++];
+    const std::vector<int> satisfied = occurs[index(p)];
+    for (int row : satisfied)
+      {
+      remove(row);
+      }
+    const std::vector<int> falsified = occurs[index(~p)];
+    for (int row : falsified)
+      {
+      if (!rows[row].removed && !strengthen(row, ~p))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+  }
+
+// Finds the strongly connected components of the binary implication graph
+// (Tarjan). All literals of a component are equivalent; every unfrozen
+// variable is replaced by the representative of its component, which is a
+// frozen variable if the component contains one.
+bool Simplifier::substitute()
+  {
+  const int nodes = occurs.size();
+  std::vector<int> number(nodes, -1);
+  std::vector<int> lowlink(nodes, 0);
+  std::vector<int> component(nodes, -1);
+  std::vector<int> stack;
+  std::vector<std::pair<int, std::size_t>> calls;
+  std::vector<std::vector<int>> components;
+  int counter = 0;
+
+  // the successors of literal p are the literals q of clauses (~p | q)
+  auto successor = [this](int node, std::size_t& edge) -> int
+    {
+    const std::vector<int>& list = occurs[node ^ 1];
+    while (edge < list.size())
+      {
+      const std::vector<Lit>& lits = rows[list[edge++]].lits;
+      if (lits.size() == 2)
+        {
+        return index(lits[0]) == (node ^ 1) ? index(lits[1]) : index(lits[0]);
+        }
+      }
+    return -1;
+    };
+
+  for (int root = 0; root < nodes; ++root)
+    {
+    if (number[root] >= 0)
+      {
+      continue;
+      }
+    calls.emplace_back(root, 0);
+    number[root] = lowlink[root] = counter++;
+    stack.push_back(root);
+    while (!calls.empty())
+      {
+      const int node = calls.back().first;
+      const int next = successor(node, calls.back().second);
+      if (next >= 0)
+        {
+        if (number[next] < 0)
+          {
+          calls.emplace_back(next, 0);
+          number[next] = lowlink[next] = counter++;
+          stack.push_back(next);
+          }
+        else if (component[next] < 0)
+          {
+          lowlink[node] = std::min(lowlink[node], number[next]);
+          }
+        continue;
+        }
+      calls.pop_back();
+      if (!calls.empty())
+        {
+        const int parent = calls.back().first;
+        lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+        }
+      if (lowlink[node] == number[node])
+        {
+        components.emplace_back();
+        int member;
+        do
+          {
+          member = stack.back();
+          stack.pop_back();
+          component[member] = components.size() - 1;
+          components.back().push_back(member);
+          }
+        while (member != node);
+        }
+      }
+    }
+
+  std::vector<Lit> representative(nodes);
+  for (const std::vector<int>& members : components)
+    {
+    Lit best = toLit(members[0]);
+    for (int member : members)
+      {
+      const Lit p = toLit(member);
+      if (component[member] == component[member ^ 1])
+        {
+        return false;
+        }
+      if (frozen[var(p)] != frozen[var(best)] ? frozen[var(p)] : var(p) < var(best))
+        {
+        best = p;
+        }
+      }
+    for (int member : members)
+      {
+      representative[member] = best;
+      }
+    }
+
+  for (Var v = 0; v < Var(eliminated.size()); ++v)
+    {
+    const Lit r = representative[index(Lit(v))];
+    if (frozen[v] || eliminated[v] || var(r) == v || value(Lit(v)) != l_Undef)
+      {
+      continue;
+      }
+    push_elimination(Lit(v), std::vector<Lit>{Lit(v), ~r});
+    push_elimination(~Lit(v), std::vector<Lit>{~Lit(v)});
+    eliminated[v] = true;
+    std::vector<int> list = occurs[index(Lit(v))];
+    list.insert(list.end(), occurs[index(~Lit(v))].begin(), occurs[index(~Lit(v))].end());
+    for (int row : list)
+      {
+      std::vector<Lit> lits = rows[row].lits;
+      for (Lit& p : lits)
+        {
+        if (var(p) == v)
+          {
+          p = sign(p) ? ~r : r;
+          }
+        }
+      remove(row);
+      if (!add(std::move(lits)))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+  }
+
+// Backward subsumption and self-subsuming resolution: every clause in the
+// queue removes the clauses it subsumes and strengthens the clauses that it
+// subsumes after flipping one literal. Strengthened clauses are queued again.
+bool Simplifier::subsume(std::vector<int> queue)
+  {
+  touched.clear();
+  while (!queue.empty())
+    {
+    for (int row : queue)
+      {
+      if (rows[row].removed)
+        {
+        continue;
+        }
+      const std::vector<Lit> lits = rows[row].lits;
+      const std::uint64_t mask = rows[row].abstraction;
+      Lit best = lits[0];
+      for (Lit p : lits)
+        {
+        if (occurs[index(p)].size() + occurs[index(~p)].size() <
+            occurs[index(best)].size() + occurs[index(~best)].size())
+          {
+          best = p;
+          }
+        }
+      for (Lit q : {best, ~best})
+        {
+        const std::vector<int> list = occurs[index(q)];
+        for (int other : list)
+          {
+          const Row& candidate = rows[other];
+          if (other == row || candidate.removed ||
+              candidate.lits.size() < lits.size() ||
+              (mask & ~candidate.abstraction) != 0)
+            {
+            continue;
+            }
+          const Lit flip = subsumes(lits, candidate.lits);
+          if (flip == lit_Undef)
+            {
+            remove(other);
+            }
+          else if (flip != lit_Error && !strengthen(other, ~flip))
+            {
+            return false;
+            }
+          }
+        }
+      }
+    if (!propagate())
+      {
+      return false;
+      }
+    queue.swap(touched);
+    touched.clear();
+    }
+  return true;
+  }
+
+// Replaces the clauses that contain 'var' by all their non-tautological
+// resolvents on 'var', unless that would increase the number of clauses or
+// literals.
+bool Simplifier::eliminate(Var var)
+  {
+  const std::vector<int> pos = occurs[index(Lit(var))];
+  const std::vector<int> neg = occurs[index(~Lit(var))];
+  if (pos.size() * neg.size() > max_resolvents)
+    {
+    return true;
+    }
+  std::size_t literals = 0;
+  for (int row : pos)
+    {
+    literals += rows[row].lits.size();
+    }
+  for (int row : neg)
+    {
+    literals += rows[row].lits.size();
+    }
+  std::vector<std::vector<Lit>> resolvents;
+  std::vector<Lit> resolvent;
+  std::size_t size = 0;
+  for (int p : pos)
+    {
+    for (int n : neg)
+      {
+      if (resolve(rows[p].lits, rows[n].lits, Lit(var), resolvent))
+        {
+        size += resolvent.size();
+        resolvents.push_back(resolvent);
+        if (resolvents.size() > pos.size() + neg.size() || size > literals)
+          {
+          return true;
+          }
+        }
+      }
+    }
+
+  const bool positive = pos.size() <= neg.size();
+  const Lit pivot = positive ? Lit(var) : ~Lit(var);
+  for (int row : positive ? pos : neg)
+    {
+    push_elimination(pivot, rows[row].lits);
+    }
+  push_elimination(~pivot, std::vector<Lit>{~pivot});
+  eliminated[var] = true;
+  for (int row : pos)
+    {
+    remove(row);
+    }
+  for (int row : neg)
+    {
+    remove(row);
+    }
+  for (std::vector<Lit>& lits : resolvents)
+    {
+    if (!add(std::move(lits)))
+      {
+      return false;
+      }
+    }
+  return true;
+  }
+
+bool Simplifier::eliminate()
+  {
+  std::vector<Var> order;
+  for (Var v = 0; v < Var(eliminated.size()); ++v)
+    {
+    if (!frozen[v] && !eliminated[v] && value(Lit(v)) == l_Undef)
+      {
+      order.push_back(v);
+      }
+    }
+  auto occurrences = [this](Var v) -> std::size_t
+    {
+    return occurs[index(Lit(v))].size() + occurs[index(~Lit(v))].size();
+    };
+  std::stable_sort(order.begin(), order.end(),
+    [&occurrences](Var lhs, Var rhs) -> bool
+    {
+    return occurrences(lhs) < occurrences(rhs);
+    });
+  touched.clear();
+  for (Var v : order)
+    {
+    if (eliminated[v] || value(Lit(v)) != l_Undef)
+      {
+      continue;
+      }
+    if (!eliminate(v) || !propagate())
+      {
+      return false;
+      }
+    }
+  std::vector<int> queue;
+  queue.swap(touched);
+  return subsume(std::move(queue));
+  }
+
+// Records a clause of an eliminated variable for extend(), pivot first and
+// followed by the clause size.
+void Simplifier::push_elimination(Lit pivot, const std::vector<Lit>& lits)
+  {
+  stack.push_back(pivot);
+  for (Lit p : lits)
+    {
+    if (p != pivot)
+      {
+      stack.push_back(p);
+      }
+    }
+  stack.push_back(toLit(lits.size()));
+  }
+
+} // namespace Karrot
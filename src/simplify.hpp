@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_SIMPLIFY_HPP
+#define KARROT_SIMPLIFY_HPP
+
+#include "minisat/SolverTypes.h"
+#include <cstdint>
+#include <vector>
+
+namespace Karrot
+{
+
+// A CNF formula under construction. The clause generators write into a
+// Formula instead of the Solver, so that it can be simplified first.
+class Formula
+  {
+  public:
+    Var newVar(bool decision = true)
+      {
+      decisions.push_back(decision);
+      return decisions.size() - 1;
+      }
+    int nVars() const
+      {
+      return decisions.size();
+      }
+    bool decision(Var var) const
+      {
+      return decisions[var];
+      }
+    void addUnit(Lit p)
+      {
+      clauses.push_back(std::vector<Lit>{p});
+      }
+    void addBinary(Lit p, Lit q)
+      {
+      clauses.push_back(std::vector<Lit>{p, q});
+      }
+    void addClause(const vec<Lit>& ps)
+      {
+      clauses.emplace_back();
+      for (int i = 0; i < ps.size(); ++i)
+        {
+        clauses.back().push_back(ps[i]);
+        }
+      }
+  public:
+    std::vector<std::vector<Lit>> clauses;
+  private:
+    std::vector<bool> decisions;
+  };
+
+// SatELite-style preprocessing (Een and Biere, 2005): unit propagation,
+// equivalent literal substitution, subsumption, self-subsuming resolution and
+// bounded variable elimination. Frozen variables are never eliminated or
+// substituted, so their meaning and the preference order over them are
+// preserved.
+class Simplifier
+  {
+  public:
+    Simplifier(Formula& formula, const std::vector<bool>& frozen);
+    // Rewrites the formula in place. Returns false if it is unsatisfiable.
+    bool simplify();
+    // Completes a model of the simplified formula to a model of the original
+    // one by assigning the eliminated variables. Unassigned variables count
+    // as false.
+    void extend(vec<lbool>& model) const;
+  private:
+    class Row
+      {
+      public:
+        std::vector<Lit> lits;  // sorted, no duplicates, no tautologies
+        std::uint64_t abstraction;
+        bool removed;
+      };
+  private:
+    lbool value(Lit p) const;
+    bool assign(Lit p);
+    bool add(std::vector<Lit> lits);
+    void remove(int row);
+    bool strengthen(int row, Lit p);
+    bool propagate();
+    bool substitute();
+    bool subsume(std::vector<int> queue);
+    bool eliminate(Var var);
+    bool eliminate();
+    void push_elimination(Lit pivot, const std::vector<Lit>& lits);
+  private:
+    Formula& formula;
+    std::vector<bool> frozen;
+    std::vector<bool> eliminated;
+    std::vector<char> assigns;
+    std::vector<Lit> trail;
+    std::size_t head;
+    std::vector<Row> rows;
+    std::vector<std::vector<int>> occurs;
+    std::vector<int> touched;
+    std::vector<Lit> stack;
+  };
+
+} // namespace Karrot
+
+#endif /* KARROT_SIMPLIFY_HPP */
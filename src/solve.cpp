@@ -7,60 +7,289 @@
  */
 
 #include "solve.hpp"
-#include "hash.hpp"
+#include "index.hpp"
 #include "query.hpp"
 #include "vercmp.hpp"
+#include "simplify.hpp"
+#include "portfolio.hpp"
+#include "optimize.hpp"
+#include "enumerate.hpp"
+#include "core.hpp"
+#include "dimacs.hpp"
+#include "warm_start.hpp"
 #include "minisat/Solver.h"
 #include "url.hpp"
 #include "log.hpp"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <deque>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 
 namespace Karrot
 {
 
-static inline std::size_t hash_artefact(const std::string& id)
+static Candidates make_candidates(const Database& database)
   {
-  std::hash<std::string> hash_fn;
-  return hash_fn(id);
+  Candidates candidates;
+  candidates.reserve(database.size());
+  for (const KImplementation& impl : database)
+    {
+    candidates.emplace_back(impl.version, *impl.variant);
+    }
+  return candidates;
   }
 
-static void query(
-    const Hash& hash,
+// Hash-conses the specs seen during clause generation. Thousands of
+// implementations usually share the same dependency, so each distinct spec is
+// resolved against the index only once. Resolving is deferred until resolve()
+// is called, which spreads the pending specs over worker threads. Every spec
+// writes its own candidate list, so the result does not depend on scheduling.
+class SpecCache
+  {
+  public:
+    explicit SpecCache(const ProjectIndex& index)
+      : index(index)
+      , resolved(0)
+      {
+      }
+    std::size_t lookup(const Spec& spec)
+      {
+      auto address = addresses.find(&spec);
+      if (address != addresses.end())
+        {
+        return address->second;
+        }
+      auto key = std::make_tuple(spec.id, spec.component, spec.query_str);
+      auto value = values.find(key);
+      if (value == values.end())
+        {
+        value = values.emplace(std::move(key), specs.size()).first;
+        specs.push_back(&spec);
+        }
+      addresses.emplace(&spec, value->second);
+      return value->second;
+      }
+    // Like lookup(), but does not take 'spec' in if it is not known yet.
+    bool find(const Spec& spec, std::size_t& id) const
+      {
+      auto value = values.find(std::make_tuple(spec.id, spec.component, spec.query_str));
+      if (value == values.end())
+        {
+        return false;
+        }
+      id = value->second;
+      return true;
+      }
+    void resolve()
+      {
+      const std::size_t first = resolved;
+      const std::size_t last = specs.size();
+      candidates.resize(last);
+      std::vector<std::exception_ptr> errors(last - first);
+      std::atomic<std::size_t> next(first);
+      auto worker = [&]()
+        {
+        for (std::size_t id = next++; id < last; id = next++)
+          {
+          try
+            {
+            index.query(*specs[id], candidates[id]);
+            }
+          catch (...)
+            {
+            errors[id - first] = std::current_exception();
+            }
+          }
+        };
+      std::size_t concurrency = std::thread::hardware_concurrency();
+      std::size_t count = std::min(concurrency, (last - first) / 64);
+      std::vector<std::thread> threads;
+      for (std::size_t i = 1; i < count; ++i)
+        {
+        threads.emplace_back(worker);
+        }
+      worker();
+      for (std::thread& thread : threads)
+        {
+        thread.join();
+        }
+      resolved = last;
+      for (const std::exception_ptr& error : errors)
+        {
+        if (error)
+          {
+          std::rethrow_exception(error);
+          }
+        }
+      }
+    const std::vector<int>& operator[](std::size_t id) const
+      {
+      return candidates[id];
+      }
+    std::size_t size() const
+      {
+      return specs.size();
+      }
+  private:
+    const ProjectIndex& index;
+    std::unordered_map<const Spec*, std::size_t> addresses;
+    std::map<std::tuple<std::string, std::string, std::string>, std::size_t> values;
+    std::vector<const Spec*> specs;
+    std::vector<std::vector<int>> candidates;
+    std::size_t resolved;
+  };
+
+// Dependency or conflict edges from an implementation to a hash-consed spec.
+typedef std::vector<std::pair<int, std::size_t>> Edges;
+
+static void collect_edges(
+    SpecCache& cache,
     const Database& database,
-    const Spec& spec,
-    vec<Lit>& res)
+    const std::vector<int>& subset,
+    SpecList KImplementation::*specs,
+    Edges& edges)
   {
-  int id;
-  std::size_t h = hash_artefact(spec.id) & hash.mask;
-  std::size_t hh = hash.begin();
-  while ((id = hash.table[h]) != 0)
+  for (int i : subset)
     {
-    if (satisfies(database[id - 1], spec))
+    for (const Spec& spec : database[i].*specs)
       {
-      res.push(Lit(id - 1));
+      edges.emplace_back(i, cache.lookup(spec));
       }
-    h = hash.next(h, hh);
     }
   }
 
+// The implementations that can be part of a solution: the candidates of the
+// requests and, transitively, the candidates of their dependencies. Only these
+// are encoded; 'vars' maps a database index to its solver variable, or to
+// var_Undef if the implementation is unreachable. Unreachable implementations
+// are false in every model that the full instance would yield.
+class Reachable
+  {
+  public:
+    Reachable(
+        SpecCache& cache,
+        const Database& database,
+        const std::vector<std::size_t>& roots)
+      : vars(database.size(), var_Undef)
+      {
+      std::vector<int> frontier;
+      for (std::size_t id : roots)
+        {
+        visit(cache[id], frontier);
+        }
+      expand(cache, database, frontier);
+      }
+    // All implementations of the database, independent of any request.
+    Reachable(SpecCache& cache, const Database& database)
+      : vars(database.size(), var_Undef)
+      {
+      std::vector<int> all(database.size());
+      std::iota(all.begin(), all.end(), 0);
+      std::vector<int> frontier;
+      visit(all, frontier);
+      expand(cache, database, frontier);
+      }
+  private:
+    void expand(SpecCache& cache, const Database& database, std::vector<int>& frontier)
+      {
+      while (!frontier.empty())
+        {
+        std::size_t first = depends.size();
+        collect_edges(cache, database, frontier, &KImplementation::depends, depends);
+        cache.resolve();
+        frontier.clear();
+        for (std::size_t e = first; e < depends.size(); ++e)
+          {
+          visit(cache[depends[e].second], frontier);
+          }
+        }
+      for (std::size_t i = 0; i < vars.size(); ++i)
+        {
+        if (vars[i] != var_Undef)
+          {
+          vars[i] = indices.size();
+          indices.push_back(i);
+          }
+        }
+      std::stable_sort(depends.begin(), depends.end(),
+        [](const Edges::value_type& lhs, const Edges::value_type& rhs) -> bool
+        {
+        return lhs.first < rhs.first;
+        });
+      }
+    void visit(const std::vector<int>& candidates, std::vector<int>& frontier)
+      {
+      for (int i : candidates)
+        {
+        if (vars[i] == var_Undef)
+          {
+          vars[i] = 0;
+          frontier.push_back(i);
+          }
+        }
+      }
+  public:
+    std::vector<int> indices;
+    std::vector<Var> vars;
+    Edges depends;
+  };
+
+static void literals(
+    const std::vector<int>& candidates,
+    const std::vector<Var>& vars,
+    vec<Lit>& result)
+  {
+  for (int i : candidates)
+    {
+    if (vars[i] != var_Undef)
+      {
+      result.push(Lit(vars[i]));
+      }
+    }
+  }
+
+static std::vector<int> count_uses(const Edges& edges, std::size_t size)
+  {
+  std::vector<int> uses(size);
+  for (const auto& edge : edges)
+    {
+    ++uses[edge.second];
+    }
+  return uses;
+  }
+
 // 1. prefer binary packages
 // 2. prefer fewer dependencies
 // 3. prefer older releases
-static std::vector<Var> make_preferences(const Database& database)
+// 4. prefer earlier database entries
+static std::vector<Var> make_preferences(
+    const Database& database,
+    const Candidates& candidates,
+    const std::vector<int>& indices)
   {
   Var i = 0;
-  std::vector<Var> preferences(database.size());
+  std::vector<Var> preferences(indices.size());
   std::generate(std::begin(preferences), std::end(preferences),
     [&i]() -> Var
     {
     return i++;
     });
   std::sort(std::begin(preferences), std::end(preferences),
-    [&database](Var var1, Var var2) -> bool
+    [&database, &candidates, &indices](Var var1, Var var2) -> bool
     {
-    const KImplementation& impl1 = database[var1];
-    const KImplementation& impl2 = database[var2];
+    const int index1 = indices[var1];
+    const int index2 = indices[var2];
+    const KImplementation& impl1 = database[index1];
+    const KImplementation& impl2 = database[index2];
     if (impl1.component != "SOURCE" && impl2.component == "SOURCE")
       {
       return true;
@@ -77,53 +306,183 @@ static std::vector<Var> make_preferences(const Database& database)
       {
       return false;
       }
-    return vercmp(impl1.version.c_str(), impl2.version.c_str()) < 0;
+    const VersionKey& key1 = candidates[index1].version_key;
+    const VersionKey& key2 = candidates[index2].version_key;
+    if (key1 < key2)
+      {
+      return true;
+      }
+    if (key2 < key1)
+      {
+      return false;
+      }
+    return index1 < index2;
     });
   return std::move(preferences);
   }
 
-static void dependency_clauses(
-    const Hash& hash,
+// The weight of each implementation in the objective of SolveOptions. The
+// staleness of an implementation is the number of newer versions of the same
+// project that are reachable.
+static std::vector<int> objective(
+    const SolveOptions& options,
     const Database& database,
-    Solver& solver)
+    const Candidates& candidates,
+    const std::vector<int>& indices)
   {
-  for (std::size_t i = 0; i < database.size(); ++i)
+  std::map<std::string, std::vector<VersionKey>> versions;
+  if (options.minimize_staleness > 0)
     {
-    for (const Spec& spec : database[i].depends)
+    for (int index : indices)
       {
-      vec<Lit> clause;
-      clause.push(~Lit(i));
-      query(hash, database, spec, clause);
-      if (clause.size() == 1)
+      versions[database[index].id].push_back(candidates[index].version_key);
+      }
+    for (auto& entry : versions)
+      {
+      std::vector<VersionKey>& keys = entry.second;
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      }
+    }
+  std::vector<int> weights(indices.size(), options.minimize_implementations);
+  for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+    const KImplementation& impl = database[indices[i]];
+    if (impl.component == "SOURCE")
+      {
+      weights[i] += options.minimize_sources;
+      }
+    if (options.minimize_staleness > 0)
+      {
+      const std::vector<VersionKey>& keys = versions[impl.id];
+      const VersionKey& key = candidates[indices[i]].version_key;
+      const int newer = keys.end() - std::upper_bound(keys.begin(), keys.end(), key);
+      weights[i] += options.minimize_staleness * newer;
+      }
+    }
+  return weights;
+  }
+
+// A candidate set that is required by more than one implementation gets an
+// auxiliary variable 'a' with the clause (~a | c1 | ... | cn), so that every
+// dependent only needs the binary clause (~i | a). The auxiliary variables are
+// never decided on, they are only ever propagated.
+static void dependency_clauses(
+    const SpecCache& cache,
+    const Edges& edges,
+    const std::vector<Var>& vars,
+    Formula& formula)
+  {
+  std::vector<int> uses = count_uses(edges, cache.size());
+  std::vector<Var> shared(cache.size(), var_Undef);
+  for (const auto& edge : edges)
+    {
+    const std::vector<int>& candidates = cache[edge.second];
+    Lit lit = ~Lit(vars[edge.first]);
+    if (candidates.size() > 1 && uses[edge.second] > 1)
+      {
+      Var& aux = shared[edge.second];
+      if (aux == var_Undef)
         {
-        solver.addUnit(clause[0]);
+        aux = formula.newVar(false);
+        vec<Lit> clause;
+        clause.push(~Lit(aux));
+        literals(candidates, vars, clause);
+        formula.addClause(clause);
         }
-      else
+      formula.addBinary(lit, Lit(aux));
+      continue;
+      }
+    vec<Lit> clause;
+    clause.push(lit);
+    literals(candidates, vars, clause);
+    if (clause.size() == 1)
+      {
+      formula.addUnit(clause[0]);
+      }
+    else
+      {
+      formula.addClause(clause);
+      }
+    }
+  }
+
+// Shared conflicts work the same way: (~i | b) for every implementation and
+// (~b | ~c) for every candidate, instead of (~i | ~c) for every pair.
+static void explicit_conflict_clauses(
+    const SpecCache& cache,
+    const Edges& edges,
+    const std::vector<Var>& vars,
+    Formula& formula)
+  {
+  std::vector<int> uses = count_uses(edges, cache.size());
+  std::vector<Var> shared(cache.size(), var_Undef);
+  for (const auto& edge : edges)
+    {
+    vec<Lit> conflicts;
+    literals(cache[edge.second], vars, conflicts);
+    Lit lit = ~Lit(vars[edge.first]);
+    if (conflicts.size() > 1 && uses[edge.second] > 1)
+      {
+      Var& aux = shared[edge.second];
+      if (aux == var_Undef)
         {
-        solver.addClause(clause);
+        aux = formula.newVar(false);
+        for (int k = 0; k < conflicts.size(); ++k)
+          {
+          formula.addBinary(~Lit(aux), ~conflicts[k]);
+          }
         }
+      formula.addBinary(lit, Lit(aux));
+      continue;
+      }
+    for (int k = 0; k < conflicts.size(); ++k)
+      {
+      formula.addBinary(lit, ~conflicts[k]);
       }
     }
   }
 
-static void explicit_conflict_clauses(
-    const Hash& hash,
-    const Database& database,
-    Solver& solver)
+// Adds clauses that allow at most one of the literals to be true. Short lists
+// are encoded pairwise, longer ones with a sequential counter (Sinz 2005),
+// which needs 3n-4 clauses and n-1 auxiliary variables instead of n(n-1)/2
+// clauses. The counter variables are never decided on.
+static void at_most_one(const vec<Lit>& lits, Formula& formula)
   {
-  for (std::size_t i = 0; i < database.size(); ++i)
+  const int size = lits.size();
+  if (size <= 5)
     {
-    Lit lit = ~Lit(i);
-    for (const Spec& spec : database[i].conflicts)
+    for (int i = 0; i < size; ++i)
       {
-      vec<Lit> conflicts;
-      query(hash, database, spec, conflicts);
-      for (int k = 0; k < conflicts.size(); ++k)
+      for (int k = i + 1; k < size; ++k)
         {
-        solver.addBinary(lit, ~conflicts[k]);
+        formula.addBinary(~lits[i], ~lits[k]);
         }
       }
+    return;
+    }
+  Lit prev = Lit(formula.newVar(false));
+  formula.addBinary(~lits[0], prev);
+  for (int i = 1; i < size - 1; ++i)
+    {
+    Lit next = Lit(formula.newVar(false));
+    formula.addBinary(~lits[i], next);
+    formula.addBinary(~prev, next);
+    formula.addBinary(~lits[i], ~prev);
+    prev = next;
     }
+  formula.addBinary(~lits[size - 1], ~prev);
+  }
+
+// The end of the implementations of the project that starts at 'begin'.
+static std::size_t project_end(const Database& database, std::size_t begin)
+  {
+  std::size_t end = begin + 1;
+  while (end < database.size() && database[end].id == database[begin].id)
+    {
+    ++end;
+    }
+  return end;
   }
 
 // Implementations of the same project either complement or conflict each other.
@@ -131,135 +490,1069 @@ static void explicit_conflict_clauses(
 // each other when both have the same version and variant. If version and
 // variant differ, the version does not match, or one implementation provides
 // all components, there is a conflict.
-static void implicit_conflict_clauses(const Database& database, Solver& solver)
+//
+// Implementations with the same version and variant form a build. Within a
+// build, at most one implementation may provide each component. A build with
+// several members is represented by a selector variable that each member
+// implies. Across the project, at most one build or "*"/"SOURCE"
+// implementation may be selected.
+static void project_conflict_clauses(
+    const Database& database,
+    std::size_t begin,
+    std::size_t end,
+    const std::vector<Var>& vars,
+    Formula& formula)
   {
-  for (std::size_t i = 0; i < database.size(); ++i)
+  typedef std::pair<const std::string*, const KDictionary*> BuildKey;
+  auto build_less = [](const BuildKey& lhs, const BuildKey& rhs) -> bool
     {
-    for (std::size_t k = i + 1; k < database.size(); ++k)
+    int result = lhs.first->compare(*rhs.first);
+    return result < 0 || (result == 0 && lhs.second < rhs.second);
+    };
+  std::map<BuildKey, std::size_t, decltype(build_less)> lookup(build_less);
+  std::vector<std::map<std::string, std::vector<int>>> builds;
+  vec<Lit> exclusive;
+  for (std::size_t i = begin; i < end; ++i)
+    {
+    const KImplementation& impl = database[i];
+    if (vars[i] == var_Undef)
       {
-      const KImplementation& impl1 = database[i];
-      const KImplementation& impl2 = database[k];
-      if (impl1.id != impl2.id)
-        {
-        break;
-        }
-      if (impl1.version != impl2.version ||
-          impl1.variant != impl2.variant ||
-          impl1.component == impl2.component ||
-          impl1.component == "*" || impl2.component == "*" ||
-          impl1.component == "SOURCE" || impl2.component == "SOURCE")
+      continue;
+      }
+    if (impl.component == "*" || impl.component == "SOURCE")
+      {
+      exclusive.push(Lit(vars[i]));
+      continue;
+      }
+    BuildKey key(&impl.version, impl.variant);
+    auto entry = lookup.emplace(key, builds.size()).first;
+    if (entry->second == builds.size())
+      {
+      builds.emplace_back();
+      }
+    builds[entry->second][impl.component].push_back(i);
+    }
+
+  for (const auto& build : builds)
+    {
+    vec<Lit> members;
+    for (const auto& component : build)
+      {
+      vec<Lit> duplicates;
+      for (int i : component.second)
         {
-        solver.addBinary(~Lit(i), ~Lit(k));
+        members.push(Lit(vars[i]));
+        duplicates.push(Lit(vars[i]));
         }
+      at_most_one(duplicates, formula);
+      }
+    if (members.size() == 1)
+      {
+      exclusive.push(members[0]);
+      continue;
       }
+    Lit selector = Lit(formula.newVar(false));
+    for (int i = 0; i < members.size(); ++i)
+      {
+      formula.addBinary(~members[i], selector);
+      }
+    exclusive.push(selector);
+    }
+  at_most_one(exclusive, formula);
+  }
+
+static void implicit_conflict_clauses(
+    const Database& database,
+    const std::vector<Var>& vars,
+    Formula& formula)
+  {
+  std::size_t begin = 0;
+  while (begin < database.size())
+    {
+    const std::size_t end = project_end(database, begin);
+    project_conflict_clauses(database, begin, end, vars, formula);
+    begin = end;
     }
   }
 
 // If a project is built from source, all dependent projects should be built
-// from source too.
-static void source_conflict_clauses(const Database& database, Solver& solver)
+// from source too. The dependency edges double as reverse-dependency index:
+// the SOURCE implementations that satisfy a spec conflict
+// with every binary implementation that depends on that spec. When several
+// of each share a spec, an auxiliary variable 'b' connects them with
+// (~s | b) and (~b | ~k) instead of a clause for every pair.
+static void source_conflict_clauses(
+    const SpecCache& cache,
+    const Database& database,
+    const Edges& edges,
+    const std::vector<Var>& vars,
+    Formula& formula)
   {
-  for (std::size_t i = 0; i < database.size(); ++i)
+  std::vector<std::vector<int>> dependents(cache.size());
+  for (const auto& edge : edges)
     {
-    if (database[i].component != "SOURCE")
+    std::vector<int>& list = dependents[edge.second];
+    if (database[edge.first].component != "SOURCE" &&
+        (list.empty() || list.back() != edge.first))
+      {
+      list.push_back(edge.first);
+      }
+    }
+  for (std::size_t id = 0; id < dependents.size(); ++id)
+    {
+    if (dependents[id].empty())
       {
       continue;
       }
-    for (std::size_t k = 0; k < database.size(); ++k)
+    std::vector<int> sources;
+    for (int i : cache[id])
       {
-      if (database[k].component == "SOURCE")
+      if (database[i].component == "SOURCE" && vars[i] != var_Undef)
         {
-        continue;
+        sources.push_back(i);
         }
-      for (const Spec& spec : database[k].depends)
+      }
+    if (sources.size() > 1 && dependents[id].size() > 1)
+      {
+      Lit aux = Lit(formula.newVar(false));
+      for (int i : sources)
         {
-        if (satisfies(database[i], spec))
+        formula.addBinary(~Lit(vars[i]), aux);
+        }
+      for (int k : dependents[id])
+        {
+        formula.addBinary(~aux, ~Lit(vars[k]));
+        }
+      continue;
+      }
+    for (int i : sources)
+      {
+      for (int k : dependents[id])
+        {
+        formula.addBinary(~Lit(vars[i]), ~Lit(vars[k]));
+        }
+      }
+    }
+  }
+
+static bool implicit_conflict(const KImplementation& impl1, const KImplementation& impl2)
+  {
+  return impl1.version != impl2.version ||
+      impl1.variant != impl2.variant ||
+      impl1.component == impl2.component ||
+      impl1.component == "*" || impl2.component == "*" ||
+      impl1.component == "SOURCE" || impl2.component == "SOURCE";
+  }
+
+// If every request and every reachable dependency has exactly one candidate,
+// all reachable implementations are forced by unit propagation and there is
+// no choice left for the SAT solver to make. The reachable set is the model,
+// unless two of its members conflict; that case is left to the formula.
+static bool propagation_complete(
+    const SpecCache& cache,
+    const Database& database,
+    const Reachable& reachable,
+    const std::vector<std::size_t>& choices,
+    const Edges& conflicts,
+    bool ignore_source_conflicts)
+  {
+  for (std::size_t id : choices)
+    {
+    if (cache[id].size() != 1)
+      {
+      return false;
+      }
+    }
+  for (const auto& edge : reachable.depends)
+    {
+    if (cache[edge.second].size() != 1)
+      {
+      return false;
+      }
+    if (!ignore_source_conflicts &&
+        database[edge.first].component != "SOURCE" &&
+        database[cache[edge.second][0]].component == "SOURCE")
+      {
+      return false;
+      }
+    }
+  for (const auto& edge : conflicts)
+    {
+    for (int i : cache[edge.second])
+      {
+      if (reachable.vars[i] != var_Undef)
+        {
+        return false;
+        }
+      }
+    }
+  std::size_t begin = 0;
+  while (begin < database.size())
+    {
+    std::vector<int> members;
+    std::size_t end = begin;
+    while (end < database.size() && database[end].id == database[begin].id)
+      {
+      if (reachable.vars[end] != var_Undef)
+        {
+        members.push_back(end);
+        }
+      ++end;
+      }
+    for (std::size_t i = 0; i < members.size(); ++i)
+      {
+      for (std::size_t k = i + 1; k < members.size(); ++k)
+        {
+        if (implicit_conflict(database[members[i]], database[members[k]]))
           {
-          solver.addBinary(~Lit(i), ~Lit(k));
+          return false;
           }
         }
       }
+    begin = end;
     }
+  return true;
   }
 
-bool solve(
+// The clauses that do not depend on the request.
+static void encode(
+    const SpecCache& cache,
     const Database& database,
-    const Requests& requests,
+    const Reachable& reachable,
+    const Edges& conflicts,
     bool ignore_source_conflicts,
-    KPrintFun log,
-    std::vector<int>& model)
+    Formula& formula)
   {
-  Hash hash;
-  if (hash.rehash_needed(database.size()))
+  dependency_clauses(cache, reachable.depends, reachable.vars, formula);
+  explicit_conflict_clauses(cache, conflicts, reachable.vars, formula);
+  implicit_conflict_clauses(database, reachable.vars, formula);
+  if (!ignore_source_conflicts)
     {
-    for (std::size_t i = 0; i < database.size(); ++i)
+    source_conflict_clauses(cache, database, reachable.depends, reachable.vars, formula);
+    }
+  }
+
+// A group of clauses that is guarded by a selector variable 's', as in
+// (~s | c1 | ... | cn), so that the group can be switched off by not
+// assuming 's'. The kinds of clauses of each project form groups of their
+// own, which lets a conflict be explained in terms of requests and feeds.
+class Group
+  {
+  public:
+    enum Kind
       {
-      std::size_t h = hash_artefact(database[i].id) & hash.mask;
-      std::size_t hh = hash.begin();
-      while (hash.table[h] != 0)
+      request,
+      depends,
+      conflicts,
+      versions,
+      sources
+      };
+  public:
+    Kind kind;
+    std::size_t index;  // of the request, or of the first implementation of the project
+    Var selector;
+  };
+
+typedef std::vector<Group> Groups;
+
+// Guards the clauses from 'first' on with a new group, if there are any.
+static void guard(
+    Formula& formula,
+    std::size_t first,
+    Group::Kind kind,
+    std::size_t index,
+    Groups& groups)
+  {
+  if (first == formula.clauses.size())
+    {
+    return;
+    }
+  Group group;
+  group.kind = kind;
+  group.index = index;
+  group.selector = formula.newVar(false);
+  for (std::size_t i = first; i < formula.clauses.size(); ++i)
+    {
+    formula.clauses[i].push_back(~Lit(group.selector));
+    }
+  groups.push_back(group);
+  }
+
+// The edges of the implementations from 'begin' to 'end', which must be
+// sorted by implementation.
+static Edges project_edges(const Edges& edges, std::size_t begin, std::size_t end)
+  {
+  auto less = [](const Edges::value_type& edge, std::size_t i) -> bool
+    {
+    return edge.first < (int)i;
+    };
+  auto first = std::lower_bound(edges.begin(), edges.end(), begin, less);
+  auto last = std::lower_bound(first, edges.end(), end, less);
+  return Edges(first, last);
+  }
+
+// Like encode(), but each kind of clause of each project is guarded by a
+// group. Shared auxiliary variables are per project here.
+static void encode_groups(
+    const SpecCache& cache,
+    const Database& database,
+    const Reachable& reachable,
+    const Edges& conflicts,
+    bool ignore_source_conflicts,
+    Formula& formula,
+    Groups& groups)
+  {
+  const std::vector<Var>& vars = reachable.vars;
+  std::size_t begin = 0;
+  while (begin < database.size())
+    {
+    const std::size_t end = project_end(database, begin);
+    const Edges depends = project_edges(reachable.depends, begin, end);
+    std::size_t first = formula.clauses.size();
+    dependency_clauses(cache, depends, vars, formula);
+    guard(formula, first, Group::depends, begin, groups);
+    first = formula.clauses.size();
+    explicit_conflict_clauses(cache, project_edges(conflicts, begin, end), vars, formula);
+    guard(formula, first, Group::conflicts, begin, groups);
+    first = formula.clauses.size();
+    project_conflict_clauses(database, begin, end, vars, formula);
+    guard(formula, first, Group::versions, begin, groups);
+    if (!ignore_source_conflicts)
+      {
+      first = formula.clauses.size();
+      source_conflict_clauses(cache, database, depends, vars, formula);
+      guard(formula, first, Group::sources, begin, groups);
+      }
+    begin = end;
+    }
+  }
+
+// Logs the specs of the reachable implementations of a project.
+static void log_specs(
+    const Database& database,
+    const Reachable& reachable,
+    std::size_t begin,
+    SpecList KImplementation::*specs,
+    KPrintFun log)
+  {
+  std::set<std::string> lines;
+  for (std::size_t i = begin; i < project_end(database, begin); ++i)
+    {
+    if (reachable.vars[i] == var_Undef)
+      {
+      continue;
+      }
+    for (const Spec& spec : database[i].*specs)
+      {
+      std::stringstream stream;
+      stream << spec;
+      lines.insert(stream.str());
+      }
+    }
+  for (const std::string& line : lines)
+    {
+    Log(log, "    %1%") % line;
+    }
+  }
+
+// Logs the versions of the reachable implementations of a project.
+static void log_versions(
+    const Database& database,
+    const Reachable& reachable,
+    std::size_t begin,
+    KPrintFun log)
+  {
+  std::vector<std::string> versions;
+  for (std::size_t i = begin; i < project_end(database, begin); ++i)
+    {
+    const KImplementation& impl = database[i];
+    if (reachable.vars[i] != var_Undef &&
+        std::find(versions.begin(), versions.end(), impl.version) == versions.end())
+      {
+      versions.push_back(impl.version);
+      }
+    }
+  for (const std::string& version : versions)
+    {
+    Log(log, "    %1% %2%") % database[begin].name % version;
+    }
+  }
+
+static void log_group(
+    const Database& database,
+    const Requests& requests,
+    const Reachable& reachable,
+    const Group& group,
+    KPrintFun log)
+  {
+  const std::string& id = database[group.index].id;
+  switch (group.kind)
+    {
+    case Group::request:
+      Log(log, "  request '%1%'") % requests[group.index];
+      break;
+    case Group::depends:
+      Log(log, "  dependencies of '%1%'") % id;
+      log_specs(database, reachable, group.index, &KImplementation::depends, log);
+      break;
+    case Group::conflicts:
+      Log(log, "  conflicts declared by '%1%'") % id;
+      log_specs(database, reachable, group.index, &KImplementation::conflicts, log);
+      break;
+    case Group::versions:
+      Log(log, "  at most one version of '%1%' at a time") % id;
+      log_versions(database, reachable, group.index, log);
+      break;
+    case Group::sources:
+      Log(log, "  '%1%' is built from source if a dependency is") % id;
+      break;
+    }
+  }
+
+// Reports a minimal set of groups that cannot be satisfied together, after
+// 'solver' has failed under the assumption of all of them.
+static void log_core(
+    const Database& database,
+    const Requests& requests,
+    const Reachable& reachable,
+    const Groups& groups,
+    double time_budget,
+    Solver& solver,
+    KPrintFun log)
+  {
+  vec<Lit> core;
+  for (int i = 0; i < solver.conflict.size(); ++i)
+    {
+    core.push(~solver.conflict[i]);
+    }
+  const bool minimal = minimize_core(solver, core, time_budget, log);
+  std::vector<std::size_t> members;
+  for (int i = 0; i < core.size(); ++i)
+    {
+    auto member = std::find_if(groups.begin(), groups.end(),
+      [&core, i](const Group& group) -> bool
+      {
+      return Lit(group.selector) == core[i];
+      });
+    members.push_back(member - groups.begin());
+    }
+  std::sort(members.begin(), members.end());
+  if (minimal)
+    {
+    log("a minimal set of conflicting constraints:");
+    }
+  else
+    {
+    log("a set of conflicting constraints (search limit reached, it may not be minimal):");
+    }
+  for (std::size_t member : members)
+    {
+    log_group(database, requests, reachable, groups[member], log);
+    }
+  }
+
+static void configure(bool modern_search, Solver& solver)
+  {
+  solver.dynamic_order = modern_search;
+  solver.phase_saving = modern_search;
+  solver.luby_restarts = modern_search;
+  solver.lbd_reduction = modern_search;
+  }
+
+typedef std::chrono::steady_clock Clock;
+
+static int64 conflict_budget(const SolveOptions& options)
+  {
+  return options.conflict_limit > 0 ? options.conflict_limit : -1;
+  }
+
+// What is left of the timeout since 'start', in seconds.
+static double time_budget(const SolveOptions& options, Clock::time_point start)
+  {
+  if (options.timeout_ms <= 0)
+    {
+    return -1;
+    }
+  std::chrono::duration<double> elapsed = Clock::now() - start;
+  return std::max(0.0, options.timeout_ms / 1000.0 - elapsed.count());
+  }
+
+// Adds the effort between two snapshots of the statistics of a solver.
+static void count(
+    const SolverStats& before,
+    const SolverStats& after,
+    SolveStatistics& statistics)
+  {
+  statistics.restarts += after.starts - before.starts;
+  statistics.decisions += after.decisions - before.decisions;
+  statistics.propagations += after.propagations - before.propagations;
+  statistics.conflicts += after.conflicts - before.conflicts;
+  statistics.learnts += after.learnts - before.learnts;
+  }
+
+// Reports the progress of a solver to 'options.progress', counting from
+// the statistics 'before' the current search.
+static std::function<void(const SolverStats&)> progress(
+    const SolveOptions& options,
+    const SolverStats& before)
+  {
+  if (!options.progress)
+    {
+    return nullptr;
+    }
+  std::function<void(const SolveStatistics&)> report = options.progress;
+  return [report, before](const SolverStats& stats)
+    {
+    SolveStatistics statistics;
+    count(before, stats, statistics);
+    report(statistics);
+    };
+  }
+
+static SolveResult search_result(
+    lbool status,
+    const SolveStatistics& statistics,
+    KPrintFun log)
+  {
+  if (status == l_False)
+    {
+    log("no solution exists, because of conflicts");
+    return SolveResult::unsatisfiable;
+    }
+  if (status == l_Undef)
+    {
+    Log(log, "search limit reached after %1% conflicts, result unknown")
+      % statistics.conflicts;
+    return SolveResult::unknown;
+    }
+  return SolveResult::satisfiable;
+  }
+
+// The warm start keeps at most this many learnt clauses of at most this size.
+static const int warm_start_clauses = 10000;
+static const int warm_start_clause_size = 8;
+
+// Selected implementations of the previous run are decided true first. The
+// learnt clauses are only used if the formula has not changed.
+static void warm_start(
+    const WarmStart& previous,
+    std::uint64_t fingerprint,
+    const Database& database,
+    const Reachable& reachable,
+    Solver& solver,
+    KPrintFun log)
+  {
+  int hints = 0;
+  for (std::size_t i = 0; i < reachable.indices.size(); ++i)
+    {
+    if (previous.model.count(key(database[reachable.indices[i]])))
+      {
+      solver.setPolarity(i, false);
+      ++hints;
+      }
+    }
+  int learnts = 0;
+  if (previous.fingerprint == fingerprint)
+    {
+    for (const std::vector<Lit>& lits : previous.learnts)
+      {
+      vec<Lit> clause;
+      for (Lit p : lits)
+        {
+        if (var(p) >= solver.nVars())
+          {
+          break;
+          }
+        clause.push(p);
+        }
+      if (clause.size() == (int)lits.size())
         {
-        h = hash.next(h, hh);
+        solver.addLearnt(clause);
+        ++learnts;
         }
-      hash.table[h] = i + 1;
       }
     }
+  Log(log, "warm start with %1% phase hints and %2% learnt clauses")
+    % hints % learnts;
+  }
 
-  Solver solver(make_preferences(database));
-  for (std::size_t i = 0; i < database.size(); ++i)
+// Appends the implementations that are selected by 'result', after
+// extending it to the variables that the simplifier has eliminated.
+static void selection(
+    const Simplifier& simplifier,
+    const Reachable& reachable,
+    vec<lbool>& result,
+    std::vector<int>& model)
+  {
+  simplifier.extend(result);
+  for (std::size_t i = 0; i < reachable.indices.size(); ++i)
     {
-    solver.newVar();
+    if (result[i] == l_True)
+      {
+      model.push_back(reachable.indices[i]);
+      }
     }
+  }
 
-  vec<Lit> request;
-  for (const Spec& spec : requests)
+// Enumerates 'options.alternatives' further solutions after 'result', which
+// must not have been extended yet.
+static void enumerate_alternatives(
+    const SolveOptions& options,
+    const Simplifier& simplifier,
+    const Reachable& reachable,
+    const vec<Lit>& assumptions,
+    const vec<lbool>& result,
+    double time_budget,
+    Solver& solver,
+    KPrintFun log,
+    std::vector<std::vector<int>>& alternatives)
+  {
+  const int found = enumerate(solver, assumptions, reachable.indices.size(),
+    result, options.alternatives, time_budget, log,
+    [&](const vec<lbool>& model)
     {
-    vec<Lit> choices;
-    query(hash, database, spec, choices);
-    if (choices.size() == 0)
+    vec<lbool> extended;
+    model.copyTo(extended);
+    alternatives.emplace_back();
+    selection(simplifier, reachable, extended, alternatives.back());
+    });
+  Log(log, "%1% of %2% alternative solutions found")
+    % found % options.alternatives;
+  }
+
+static bool check_requests(
+    const Database& database,
+    const Requests& requests,
+    const SpecCache& cache,
+    const std::vector<std::size_t>& choices,
+    KPrintFun log)
+  {
+  for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+    if (cache[choices[i]].empty())
       {
-      Log(log, "no implementation satisfies '%1%'") % spec;
+      Log(log, "no implementation satisfies '%1%'") % requests[i];
       for (auto& entry : database)
         {
         Log(log, "%1%") % entry.id;
         }
       return false;
       }
-    if (choices.size() == 1)
+    }
+  return true;
+  }
+
+// Encodes the request again with guarded groups, after solve() has found
+// that there is no solution, and logs a minimal set of conflicting groups.
+// The search only has to refute the groups, so it is always the modern one.
+static void explain(
+    const SpecCache& cache,
+    const Database& database,
+    const Candidates& candidates,
+    const Requests& requests,
+    const std::vector<std::size_t>& choices,
+    const Reachable& reachable,
+    const Edges& conflicts,
+    const SolveOptions& options,
+    Clock::time_point start,
+    SolveStatistics& statistics,
+    KPrintFun log)
+  {
+  Formula formula;
+  for (std::size_t i = 0; i < reachable.indices.size(); ++i)
+    {
+    formula.newVar();
+    }
+  Groups groups;
+  for (std::size_t r = 0; r < choices.size(); ++r)
+    {
+    vec<Lit> clause;
+    literals(cache[choices[r]], reachable.vars, clause);
+    const std::size_t first = formula.clauses.size();
+    formula.addClause(clause);
+    guard(formula, first, Group::request, r, groups);
+    }
+  encode_groups(cache, database, reachable, conflicts,
+    options.ignore_source_conflicts, formula, groups);
+
+  // Only the selectors are frozen, they are assumed.
+  std::vector<bool> frozen(formula.nVars(), false);
+  vec<Lit> selectors;
+  for (const Group& group : groups)
+    {
+    frozen[group.selector] = true;
+    selectors.push(Lit(group.selector));
+    }
+  Simplifier simplifier(formula, frozen);
+  simplifier.simplify();
+
+  Solver solver(make_preferences(database, candidates, reachable.indices));
+  configure(true, solver);
+  solver.conflict_budget = conflict_budget(options);
+  solver.time_budget = time_budget(options, start);
+  load(formula, solver);
+  const lbool status = solver.solveLimited(selectors, log);
+  if (status == l_False)
+    {
+    log_core(database, requests, reachable, groups,
+      time_budget(options, start), solver, log);
+    }
+  else
+    {
+    log("search limit reached, no conflicting constraints to report");
+    }
+  count(SolverStats(), solver.stats, statistics);
+  }
+
+SolveResult solve(
+    const Database& database,
+    const Requests& requests,
+    const SolveOptions& options,
+    KPrintFun log,
+    std::vector<int>& model,
+    std::vector<std::vector<int>>& alternatives,
+    SolveStatistics& statistics)
+  {
+  const Clock::time_point start = Clock::now();
+  Candidates candidates = make_candidates(database);
+  ProjectIndex index(database, candidates);
+  SpecCache cache(index);
+
+  std::vector<std::size_t> choices;
+  for (const Spec& spec : requests)
+    {
+    choices.push_back(cache.lookup(spec));
+    }
+  cache.resolve();
+  if (!check_requests(database, requests, cache, choices, log))
+    {
+    return SolveResult::unsatisfiable;
+    }
+
+  Reachable reachable(cache, database, choices);
+  const std::vector<Var>& vars = reachable.vars;
+
+  Edges conflicts;
+  collect_edges(cache, database, reachable.indices, &KImplementation::conflicts, conflicts);
+  cache.resolve();
+
+  if (propagation_complete(cache, database, reachable, choices, conflicts,
+      options.ignore_source_conflicts))
+    {
+    Log(log, "%1% of %2% implementations reachable, solved by propagation")
+      % reachable.indices.size() % database.size();
+    model.insert(model.end(), reachable.indices.begin(), reachable.indices.end());
+    statistics.solved_by_propagation = true;
+    if (!options.warm_start.empty())
+      {
+      // There is no formula, so there are no learnt clauses and no
+      // fingerprint to key them by. The model still serves as phase hints.
+      WarmStart next;
+      for (std::size_t index : reachable.indices)
+        {
+        next.model.insert(key(database[index]));
+        }
+      next.save(options.warm_start);
+      }
+    return SolveResult::satisfiable;
+    }
+  Log(log, "%1% of %2% implementations reachable, solved by search")
+    % reachable.indices.size() % database.size();
+
+  Formula formula;
+  for (std::size_t i = 0; i < reachable.indices.size(); ++i)
+    {
+    formula.newVar();
+    }
+
+  vec<Lit> request;
+  bool ambiguous = true;
+  for (std::size_t r = 0; r < choices.size(); ++r)
+    {
+    vec<Lit> clause;
+    literals(cache[choices[r]], vars, clause);
+    ambiguous = ambiguous && clause.size() != 1;
+    if (clause.size() == 1)
       {
-      request.push(choices[0]);
+      request.push(clause[0]);
       }
     else
       {
-      solver.addClause(choices);
+      formula.addClause(clause);
       }
     }
-  if (request.size() == 0)
+  if (ambiguous)
     {
     log("Warning: request is ambiguous.");
     }
 
-  dependency_clauses(hash, database, solver);
-  explicit_conflict_clauses(hash, database, solver);
-  implicit_conflict_clauses(database, solver);
-
-  if (!ignore_source_conflicts)
+  // All implementation variables are frozen: they carry the preferences.
+  encode(cache, database, reachable, conflicts,
+    options.ignore_source_conflicts, formula);
+  Simplifier simplifier(formula, std::vector<bool>(reachable.indices.size(), true));
+  if (!simplifier.simplify())
     {
-    source_conflict_clauses(database, solver);
+    if (options.explain_conflicts)
+      {
+      explain(cache, database, candidates, requests, choices, reachable, conflicts,
+        options, start, statistics, log);
+      }
+    log("no solution exists, because of conflicts");
+    return SolveResult::unsatisfiable;
     }
 
-  if (!solver.solve(request, log))
+  std::vector<Var> preferences =
+    make_preferences(database, candidates, reachable.indices);
+  if (!options.dimacs.empty())
     {
-    log("no solution exists, because of conflicts");
-    return false;
+    Instance instance;
+    instance.formula = formula;
+    instance.preferences = preferences;
+    for (int i = 0; i < request.size(); ++i)
+      {
+      instance.assumptions.push_back(request[i]);
+      }
+    write_dimacs(options.dimacs, instance);
+    }
+  const std::vector<int> weights = options.optimizing()
+    ? objective(options, database, candidates, reachable.indices)
+    : std::vector<int>();
+  const bool optimize = options.optimizing();
+  vec<lbool> result;
+  lbool status;
+  if (options.portfolio > 1 && (optimize || options.alternatives > 0))
+    {
+    log("Warning: the portfolio is not supported with an objective or alternatives, "
+      "using one solver.");
     }
-  for (int i = 0; i < solver.nVars(); ++i)
+  if (options.portfolio > 1 && !optimize && options.alternatives <= 0)
     {
-    if (solver.model[i] == l_True)
+    if (!options.warm_start.empty())
       {
-      model.push_back(i);
+      log("Warning: the warm start is not supported with a portfolio, ignored.");
       }
+    SolverStats stats;
+    status = solve_portfolio(formula, preferences, request, options.portfolio,
+      conflict_budget(options), time_budget(options, start),
+      progress(options, SolverStats()), log, result, stats);
+    count(SolverStats(), stats, statistics);
     }
-  return true;
+  else
+    {
+    Solver solver(std::move(preferences));
+    configure(options.modern_search, solver);
+    solver.conflict_budget = conflict_budget(options);
+    solver.time_budget = time_budget(options, start);
+    solver.progress = progress(options, SolverStats());
+    load(formula, solver);
+    WarmStart next;
+    if (!options.warm_start.empty())
+      {
+      WarmStart previous;
+      next.fingerprint = fingerprint(formula);
+      if (previous.load(options.warm_start))
+        {
+        warm_start(previous, next.fingerprint, database, reachable, solver, log);
+        }
+      }
+    if (optimize)
+      {
+      bool optimal;
+      status = minimize(solver, request, weights, time_budget(options, start),
+        log, result, optimal);
+      }
+    else
+      {
+      status = solver.solveLimited(request, log);
+      if (status == l_True)
+        {
+        solver.model.copyTo(result);
+        }
+      }
+    if (status == l_True && options.alternatives > 0)
+      {
+      enumerate_alternatives(options, simplifier, reachable, request, result,
+        time_budget(options, start), solver, log, alternatives);
+      }
+    count(SolverStats(), solver.stats, statistics);
+    if (!options.warm_start.empty())
+      {
+      for (std::size_t i = 0; status == l_True && i < reachable.indices.size(); ++i)
+        {
+        if (result[i] == l_True)
+          {
+          next.model.insert(key(database[reachable.indices[i]]));
+          }
+        }
+      solver.learntClauses(warm_start_clause_size, warm_start_clauses, next.learnts);
+      // The variables of the weighted counter and the activation variable of
+      // the alternatives are not part of the formula.
+      next.learnts.erase(std::remove_if(next.learnts.begin(), next.learnts.end(),
+        [&formula](const std::vector<Lit>& clause)
+        {
+        return std::any_of(clause.begin(), clause.end(), [&formula](Lit p)
+          {
+          return var(p) >= formula.nVars();
+          });
+        }), next.learnts.end());
+      next.save(options.warm_start);
+      }
+    }
+  if (status == l_False && options.explain_conflicts)
+    {
+    explain(cache, database, candidates, requests, choices, reachable, conflicts,
+      options, start, statistics, log);
+    }
+  if (status != l_True)
+    {
+    return search_result(status, statistics, log);
+    }
+  selection(simplifier, reachable, result, model);
+  return SolveResult::satisfiable;
+  }
+
+// The whole database is encoded once. A request with a single candidate
+// becomes an assumption literal, any other request gets a selector variable
+// 's' with the clause (~s | c1 | ... | cn), and 's' is assumed. Selectors are
+// kept for later calls with the same spec. Since no clause of a request is
+// ever retracted, every learnt clause remains valid for all later calls.
+class IncrementalSolver::Impl
+  {
+  public:
+    Impl(const Database& database, const SolveOptions& options)
+      : database(database)
+      , options(options)
+      , candidates(make_candidates(database))
+      , index(database, candidates)
+      , cache(index)
+      , reachable(cache, database)
+      , solver(make_preferences(database, candidates, reachable.indices))
+      {
+      collect_edges(cache, database, reachable.indices, &KImplementation::conflicts, conflicts);
+      cache.resolve();
+      for (std::size_t i = 0; i < reachable.indices.size(); ++i)
+        {
+        formula.newVar();
+        }
+      encode(cache, database, reachable, conflicts,
+        options.ignore_source_conflicts, formula);
+      simplifier.reset(new Simplifier(formula,
+        std::vector<bool>(reachable.indices.size(), true)));
+      if (simplifier->simplify())
+        {
+        load(formula, solver);
+        }
+      else
+        {
+        vec<Lit> empty;
+        solver.addClause(empty);
+        }
+      }
+    SolveResult solve(
+        const Requests& requests,
+        KPrintFun log,
+        std::vector<int>& model,
+        std::vector<std::vector<int>>& alternatives,
+        SolveStatistics& statistics)
+      {
+      const Clock::time_point start = Clock::now();
+      std::vector<std::size_t> choices;
+      for (const Spec& spec : requests)
+        {
+        std::size_t id;
+        if (!cache.find(spec, id))
+          {
+          specs.push_back(spec);
+          id = cache.lookup(specs.back());
+          }
+        choices.push_back(id);
+        }
+      cache.resolve();
+      if (!check_requests(database, requests, cache, choices, log))
+        {
+        return SolveResult::unsatisfiable;
+        }
+
+      vec<Lit> assumptions;
+      bool ambiguous = true;
+      for (std::size_t id : choices)
+        {
+        vec<Lit> clause;
+        literals(cache[id], reachable.vars, clause);
+        if (clause.size() == 1)
+          {
+          assumptions.push(clause[0]);
+          ambiguous = false;
+          continue;
+          }
+        auto selector = selectors.find(id);
+        if (selector == selectors.end())
+          {
+          selector = selectors.emplace(id, solver.newVar(false)).first;
+          clause.push(~Lit(selector->second));
+          solver.addClause(clause);
+          }
+        assumptions.push(Lit(selector->second));
+        }
+      if (ambiguous)
+        {
+        log("Warning: request is ambiguous.");
+        }
+
+      configure(options.modern_search, solver);
+      solver.conflict_budget = conflict_budget(options);
+      solver.time_budget = time_budget(options, start);
+      const SolverStats before = solver.stats;
+      solver.progress = progress(options, before);
+      const lbool status = solver.solveLimited(assumptions, log);
+      if (status != l_True)
+        {
+        count(before, solver.stats, statistics);
+        return search_result(status, statistics, log);
+        }
+      vec<lbool> result;
+      solver.model.copyTo(result);
+      if (options.alternatives > 0)
+        {
+        enumerate_alternatives(options, *simplifier, reachable, assumptions,
+          result, time_budget(options, start), solver, log, alternatives);
+        }
+      count(before, solver.stats, statistics);
+      selection(*simplifier, reachable, result, model);
+      return SolveResult::satisfiable;
+      }
+  private:
+    const Database& database;
+    SolveOptions options;
+    Candidates candidates;
+    ProjectIndex index;
+    SpecCache cache;
+    Reachable reachable;
+    Edges conflicts;
+    Formula formula;
+    std::unique_ptr<Simplifier> simplifier;
+    Solver solver;
+    std::deque<Spec> specs;  // the cache refers to new requests by address
+    std::map<std::size_t, Var> selectors;
+  };
+
+IncrementalSolver::IncrementalSolver(const Database& database, const SolveOptions& options)
+  : impl(new Impl(database, options))
+  {
+  }
+
+IncrementalSolver::~IncrementalSolver()
+  {
+  }
+
+SolveResult IncrementalSolver::solve(
+    const Requests& requests,
+    KPrintFun log,
+    std::vector<int>& model,
+    std::vector<std::vector<int>>& alternatives,
+    SolveStatistics& statistics)
+  {
+  return impl->solve(requests, log, model, alternatives, statistics);
   }
 
 } // namespace Karrot
@@ -12,13 +12,16 @@
 #include "database.hpp"
 #include "spec.hpp"
 #include "quark.hpp"
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 #include <set>
 
 namespace Karrot
 {
 
-inline bool satisfies(const KImplementation& impl, const Spec& spec)
+inline bool provides(const KImplementation& impl, const Spec& spec)
   {
   if (impl.id != spec.id)
     {
@@ -28,17 +31,135 @@ inline bool satisfies(const KImplementation& impl, const Spec& spec)
     {
     return false;
     }
-  return spec.query.evaluate(impl.version, impl.variant);
+  return true;
+  }
+
+inline bool satisfies(const KImplementation& impl, const Spec& spec)
+  {
+  return provides(impl, spec) && spec.query.evaluate(impl.version, *impl.variant);
   }
 
 typedef std::vector<Spec> Requests;
 
-bool solve(
+// The effort of the SAT search, summed over all solvers of a portfolio.
+class SolveStatistics
+  {
+  public:
+    SolveStatistics()
+      : restarts(0)
+      , decisions(0)
+      , propagations(0)
+      , conflicts(0)
+      , learnts(0)
+      , solved_by_propagation(false)
+      {
+      }
+  public:
+    long long restarts;
+    long long decisions;
+    long long propagations;
+    long long conflicts;
+    long long learnts;  // clauses learnt, including units and binaries
+    bool solved_by_propagation;  // no formula was built, every reachable implementation is selected
+  };
+
+class SolveOptions
+  {
+  public:
+    SolveOptions()
+      : ignore_source_conflicts(false)
+      , modern_search(false)
+      , portfolio(0)
+      , incremental(false)
+      , conflict_limit(0)
+      , timeout_ms(0)
+      , minimize_sources(0)
+      , minimize_implementations(0)
+      , minimize_staleness(0)
+      , alternatives(0)
+      , explain_conflicts(false)
+      {
+      }
+    bool optimizing() const
+      {
+      return minimize_sources > 0 || minimize_implementations > 0 || minimize_staleness > 0;
+      }
+  public:
+    bool ignore_source_conflicts;
+    bool modern_search;
+    int portfolio;  // number of parallel solvers, if more than one
+    bool incremental;
+    // File that keeps the selected implementations and short learnt clauses
+    // of the previous run, empty if none. The selected implementations are
+    // decided true first, so the result may keep a previously selected
+    // version where a preferred one would do. Not supported with 'portfolio'.
+    std::string warm_start;
+    std::string dimacs;      // file name for the SAT instance, empty if none
+    int conflict_limit;  // per solver, 0 for no limit
+    int timeout_ms;      // 0 for no limit
+    // Weights of an objective to minimize, 0 to ignore a term. If any is
+    // set, a single solver searches for an optimal model (see minimize());
+    // 'portfolio' and 'incremental' are not supported.
+    int minimize_sources;          // per SOURCE implementation
+    int minimize_implementations;  // per implementation
+    int minimize_staleness;        // per newer version of the same project
+    // Number of further solutions to enumerate from the same solver after
+    // the first one (see enumerate()), 0 for none. Each selects a set of
+    // implementations that is neither equal to nor a superset of an earlier
+    // one. 'portfolio' is not supported.
+    int alternatives;
+    // If the search finds that there is no solution, the request is encoded
+    // again with each request and each kind of constraint of each project
+    // guarded by an assumption, and a minimal set of them that conflict is
+    // logged (see minimize_core()). Satisfiable requests are not affected.
+    // 'incremental' is not supported.
+    bool explain_conflicts;
+    // Called before each restart of the search. A portfolio reports the
+    // progress of its first solver only.
+    std::function<void(const SolveStatistics&)> progress;
+  };
+
+// 'unknown' means that a limit of the SolveOptions was reached first.
+enum class SolveResult
+  {
+  unsatisfiable,
+  satisfiable,
+  unknown
+  };
+
+SolveResult solve(
     Database const& database,
     Requests const& requests,
-    bool ignore_source_conflicts,
+    SolveOptions const& options,
     KPrintFun log,
-    std::vector<int>& model);
+    std::vector<int>& model,
+    std::vector<std::vector<int>>& alternatives,
+    SolveStatistics& statistics);
+
+// Keeps one solver for a database, so that consecutive request sets reuse
+// the clauses learnt for earlier ones. The models do not depend on the
+// earlier requests: they are the same as those of solve(), because the
+// static decision order yields the least model in preference order whatever
+// clauses were learnt. Repeated requests reuse their earlier encoding, so
+// the solver only grows with new distinct requests.
+// 'ignore_source_conflicts' is fixed at construction; 'portfolio',
+// 'warm_start', 'dimacs', the objective and 'explain_conflicts' are not
+// supported.
+class IncrementalSolver
+  {
+  public:
+    IncrementalSolver(const Database& database, const SolveOptions& options);
+    ~IncrementalSolver();
+    SolveResult solve(
+        const Requests& requests,
+        KPrintFun log,
+        std::vector<int>& model,
+        std::vector<std::vector<int>>& alternatives,
+        SolveStatistics& statistics);
+  private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+  };
 
 } // namespace Karrot
 
@@ -12,6 +12,8 @@
 #include "query.hpp"
 #include <iostream>
 #include <cstring>
+#include <memory>
+#include <vector>
 
 namespace Karrot
 {
@@ -69,6 +71,61 @@ class Spec
     Query query;
   };
 
+// An immutable list of specs. Copies share the same storage, so every
+// implementation with the same dependencies refers to a single list.
+class SpecList
+  {
+  public:
+    typedef std::vector<Spec>::const_iterator const_iterator;
+  public:
+    SpecList() = default;
+    explicit SpecList(std::vector<Spec> specs)
+      {
+      if (!specs.empty())
+        {
+        this->specs = std::make_shared<const std::vector<Spec>>(std::move(specs));
+        }
+      }
+    const_iterator begin() const
+      {
+      return get().begin();
+      }
+    const_iterator end() const
+      {
+      return get().end();
+      }
+    std::size_t size() const
+      {
+      return get().size();
+      }
+    bool empty() const
+      {
+      return !specs;
+      }
+    friend SpecList operator+(const SpecList& lhs, const SpecList& rhs)
+      {
+      if (rhs.empty())
+        {
+        return lhs;
+        }
+      if (lhs.empty())
+        {
+        return rhs;
+        }
+      std::vector<Spec> result(lhs.begin(), lhs.end());
+      result.insert(result.end(), rhs.begin(), rhs.end());
+      return SpecList(std::move(result));
+      }
+  private:
+    const std::vector<Spec>& get() const
+      {
+      static const std::vector<Spec> none;
+      return specs ? *specs : none;
+      }
+  private:
+    std::shared_ptr<const std::vector<Spec>> specs;
+  };
+
 } // namespace Karrot
 
 #endif /* KARROT_SPEC_HPP */
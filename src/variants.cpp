@@ -7,82 +7,152 @@
  */
 
 #include "variants.hpp"
+#include "quark.hpp"
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
-#include <boost/fusion/adapted/std_pair.hpp>
-#include <boost/spirit/include/qi_nonterminal.hpp>
-#include <boost/spirit/include/qi_operator.hpp>
-#include <boost/spirit/include/qi_parse.hpp>
-#include <boost/spirit/include/qi_char.hpp>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace Karrot
 {
 
-namespace qi = boost::spirit::qi;
+static inline bool is_alpha(char c)
+  {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+  }
+
+static inline bool is_alnum(char c)
+  {
+  return is_alpha(c) || (c >= '0' && c <= '9') || c == '_';
+  }
 
-template<typename Iterator>
-struct DictionaryGrammar: qi::grammar<Iterator, KDictionary()>
+// dict  = entry % ';'
+// entry = [a-zA-Z][a-zA-Z_0-9]* '=' [a-zA-Z_0-9]+
+//
+// Parsing stops at the first entry that does not match. Only a string that
+// does not start with a valid entry is an error.
+static bool parse_dictionary(const std::string& string, KDictionary& result)
   {
-  DictionaryGrammar() : DictionaryGrammar::base_type(dict)
+  std::string::const_iterator cur = string.begin();
+  std::string::const_iterator end = string.end();
+  for (bool first = true;; first = false)
     {
-    dict = entry % ';';
-    entry = key >> '=' >> value;
-    key = qi::char_("a-zA-Z") >> *qi::char_("a-zA-Z_0-9");
-    value = +qi::char_("a-zA-Z_0-9");
+    std::string::const_iterator pos = cur;
+    if (!first)
+      {
+      if (pos == end || *pos != ';')
+        {
+        break;
+        }
+      ++pos;
+      }
+    std::string::const_iterator key = pos;
+    if (pos == end || !is_alpha(*pos))
+      {
+      break;
+      }
+    while (++pos != end && is_alnum(*pos))
+      {
+      }
+    std::string::const_iterator key_end = pos;
+    if (pos == end || *pos != '=')
+      {
+      break;
+      }
+    std::string::const_iterator value = ++pos;
+    while (pos != end && is_alnum(*pos))
+      {
+      ++pos;
+      }
+    if (pos == value)
+      {
+      break;
+      }
+    result.insert(std::make_pair(std::string(key, key_end), std::string(value, pos)));
+    cur = pos;
     }
-  qi::rule<Iterator, KDictionary()> dict;
-  qi::rule<Iterator, std::pair<std::string, std::string>()> entry;
-  qi::rule<Iterator, std::string()> key, value;
-  };
+  return cur != string.begin();
+  }
+
+// Variants are interned like quarks: every distinct variant is stored once and
+// lives until the end of the program.
+const KDictionary* intern_variant(const KDictionary& variant)
+  {
+  static std::set<KDictionary> variants;
+  return &*variants.insert(variant).first;
+  }
 
-KDictionary parse_variant(const std::string& string)
+const KDictionary* parse_variant(const std::string& string)
   {
+  static std::unordered_map<std::string, const KDictionary*> cache;
+  auto it = cache.find(string);
+  if (it != cache.end())
+    {
+    return it->second;
+    }
   KDictionary result;
-  auto begin = string.begin();
-  DictionaryGrammar<decltype(begin)> grammar;
-  if (!qi::parse(begin, string.end(), grammar, result))
+  if (!parse_dictionary(string, result))
     {
     throw std::runtime_error("invalid variant: " + string);
     }
-  return result;
+  const KDictionary* variant = intern_variant(result);
+  cache.insert(std::make_pair(string, variant));
+  return variant;
+  }
+
+VariantEnumerator::VariantEnumerator(const KDictionary& variants)
+  {
+  axes.reserve(variants.size());
+  for (const auto& entry : variants)
+    {
+    Axis axis;
+    split(axis.values, entry.second, boost::is_any_of(";"), boost::token_compress_on);
+    auto it = variant.insert(std::make_pair(entry.first, axis.values[0])).first;
+    axis.key = &it->first;
+    axis.value = &it->second;
+    axis.index = 0;
+    axis.position = quark_variant.size();
+    for (std::size_t i = 0; i < axis.values.size(); ++i)
+      {
+      axis.value_quarks.push_back(to_quark(axis.values[i]));
+      axis.active.push_back(i);
+      }
+    quark_variant.emplace_back(to_quark(entry.first), axis.value_quarks[0]);
+    axes.push_back(std::move(axis));
+    }
   }
 
-static void r_variants_recurse(
-    const KDictionary::const_iterator& cur,
-    const KDictionary::const_iterator& end,
-    const KDictionary& dict,
-    const std::function<void(KDictionary)>& func)
+// Advance like an odometer: the last axis spins fastest, which yields the
+// same order as a nested loop over the axes in key order.
+bool VariantEnumerator::next()
   {
-  assert(cur != end);
-  std::vector<std::string> values;
-  split(values, cur->second, boost::is_any_of(";"), boost::token_compress_on);
-  for (const std::string& val : values)
+  for (auto it = axes.rbegin(); it != axes.rend(); ++it)
     {
-    KDictionary copy(dict);
-    copy.insert(std::make_pair(cur->first, val));
-    if (std::next(cur) == end)
+    if (it->active.empty())
       {
-      func(copy);
+      return false;
       }
-    else
+    if (it->index + 1 < it->active.size())
       {
-      r_variants_recurse(std::next(cur), end, copy, func);
+      select(*it, it->index + 1);
+      return true;
       }
+    select(*it, 0);
     }
+  return false;
   }
 
 void foreach_variant(
     const KDictionary& variants,
-    const std::function<void(KDictionary)>& func)
+    const std::function<void(const KDictionary&)>& func)
   {
-  if (variants.empty())
-    {
-    func(KDictionary());
-    }
-  else
+  VariantEnumerator enumerator(variants);
+  do
     {
-    r_variants_recurse(variants.begin(), variants.end(), KDictionary(), func);
+    func(enumerator.current());
     }
+  while (enumerator.next());
   }
 
 } // namespace Karrot
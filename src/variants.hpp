@@ -16,10 +16,88 @@
 namespace Karrot
 {
 
-KDictionary parse_variant(const std::string& quark);
+const KDictionary* intern_variant(const KDictionary& variant);
+const KDictionary* parse_variant(const std::string& string);
+
+// Enumerates the cartesian product of all variant values. Each axis is split
+// once on construction. The current combination is kept in a single
+// dictionary that is updated in place when the enumerator is advanced, so
+// references returned by 'current()' stay valid until destruction. Once the
+// last combination is passed, 'next()' returns false and the enumerator is back
+// at the first combination. The values are also resolved to quarks once, so
+// 'quarks()' gives the current combination in the form of Candidate::variant.
+class VariantEnumerator
+  {
+  public:
+    explicit VariantEnumerator(const KDictionary& variants);
+    VariantEnumerator(const VariantEnumerator&) = delete;
+    VariantEnumerator& operator=(const VariantEnumerator&) = delete;
+    const KDictionary& current() const
+      {
+      return variant;
+      }
+    const std::vector<std::pair<int, int>>& quarks() const
+      {
+      return quark_variant;
+      }
+    bool next();
+    // Restricts every axis to the values for which 'predicate(key, value)'
+    // holds and rewinds to the first combination. Restrictions do not
+    // accumulate; each call starts from the full set of values. Returns false
+    // if any axis is left without values.
+    template<typename Predicate>
+    bool restrict(const Predicate& predicate)
+      {
+      bool nonempty = true;
+      for (Axis& axis : axes)
+        {
+        axis.active.clear();
+        for (std::size_t i = 0; i < axis.values.size(); ++i)
+          {
+          if (predicate(*axis.key, axis.values[i]))
+            {
+            axis.active.push_back(i);
+            }
+          }
+        axis.index = 0;
+        if (axis.active.empty())
+          {
+          nonempty = false;
+          }
+        else
+          {
+          select(axis, 0);
+          }
+        }
+      return nonempty;
+      }
+  private:
+    class Axis
+      {
+      public:
+        const std::string* key;
+        std::string* value;
+        std::vector<std::string> values;
+        std::vector<int> value_quarks;
+        std::vector<std::size_t> active;
+        std::size_t index;
+        std::size_t position;  // in 'quark_variant'
+      };
+    // Makes the value at 'index' of the active ones current.
+    void select(Axis& axis, std::size_t index)
+      {
+      axis.index = index;
+      *axis.value = axis.values[axis.active[index]];
+      quark_variant[axis.position].second = axis.value_quarks[axis.active[index]];
+      }
+  private:
+    KDictionary variant;
+    std::vector<std::pair<int, int>> quark_variant;  // key, value
+    std::vector<Axis> axes;
+  };
 
 void foreach_variant(const KDictionary& variants,
-    const std::function<void(KDictionary)>& function);
+    const std::function<void(const KDictionary&)>& function);
 
 } // namespace Karrot
 
@@ -92,4 +92,67 @@ int vercmp(const char *s1, const char *s2)
   return *s1 ? 1 : *s2 ? -1 : 0;
   }
 
+// Tags are chosen so that, after a common prefix, a string that has run out
+// of segments sorts first, then one that only has separators left, then one
+// that continues with letters, then one that continues with digits.
+static const char TRAILING = '\x01';
+static const char ALPHA    = '\x02';
+static const char NUMBER   = '\x03';
+
+VersionKey::VersionKey(const char *version)
+  {
+  const char *s = version;
+  while (*s)
+    {
+    while (*s && !std::isalnum(*s))
+      {
+      s++;
+      }
+    if (!*s)
+      {
+      key += TRAILING;
+      break;
+      }
+    const char *e = s;
+    if (std::isdigit(*s))
+      {
+      while (*s == '0' && std::isdigit(s[1]))
+        {
+        s++;
+        }
+      e = s;
+      while (std::isdigit(*e))
+        {
+        e++;
+        }
+      std::size_t length = e - s;
+      key += NUMBER;
+      if (length < 0xFF)
+        {
+        key += static_cast<char>(length);
+        }
+      else
+        {
+        key += '\xFF';
+        for (int shift = 24; shift >= 0; shift -= 8)
+          {
+          key += static_cast<char>((length >> shift) & 0xFF);
+          }
+        }
+      key.append(s, e);
+      }
+    else
+      {
+      while (std::isalpha(*e))
+        {
+        e++;
+        }
+      key += ALPHA;
+      key.append(s, e);
+      key += '\0';
+      }
+    s = e;
+    }
+  }
+
 } /* namespace Karrot */
@@ -9,11 +9,40 @@
 #ifndef KARROT_VERCMP_HPP
 #define KARROT_VERCMP_HPP
 
+#include <string>
+
 namespace Karrot
 {
 
 int vercmp(const char *s1, const char *s2);
 
+// A version string parsed once into a byte string that compares like
+// 'vercmp' under plain lexicographic comparison. Every numeric segment is
+// stored as its digit count followed by its digits, every alpha segment as
+// its characters followed by a terminator, each behind a tag that orders
+// numbers after letters.
+class VersionKey
+  {
+  public:
+    VersionKey() = default;
+    explicit VersionKey(const char *version);
+    int compare(const VersionKey& other) const
+      {
+      int r = key.compare(other.key);
+      return r < 0 ? -1 : r > 0 ? 1 : 0;
+      }
+    friend bool operator<(const VersionKey& lhs, const VersionKey& rhs)
+      {
+      return lhs.key < rhs.key;
+      }
+    friend bool operator==(const VersionKey& lhs, const VersionKey& rhs)
+      {
+      return lhs.key == rhs.key;
+      }
+  private:
+    std::string key;
+  };
+
 } // namespace Karrot
 
 #endif /* KARROT_VERCMP_HPP */
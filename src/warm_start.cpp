@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "warm_start.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace Karrot
+{
+
+static const char* const magic = "karrot-warm-start-1";
+
+WarmStart::WarmStart()
+  : fingerprint(0)
+  {
+  }
+
+// The file is line based:
+//
+//   karrot-warm-start-1
+//   <fingerprint>
+//   <number of implementations>
+//   <key of each selected implementation>
+//   <each learnt clause as DIMACS literals, terminated by 0>
+bool WarmStart::load(const std::string& filename)
+  {
+  std::ifstream file(filename);
+  std::string line;
+  if (!std::getline(file, line) || line != magic)
+    {
+    return false;
+    }
+  std::size_t size = 0;
+  if (!(file >> fingerprint >> size) || !std::getline(file, line))
+    {
+    return false;
+    }
+  for (std::size_t i = 0; i < size; ++i)
+    {
+    if (!std::getline(file, line))
+      {
+      return false;
+      }
+    model.insert(line);
+    }
+  while (std::getline(file, line))
+    {
+    std::istringstream stream(line);
+    std::vector<Lit> clause;
+    int dimacs = 1;
+    while (stream >> dimacs && dimacs != 0)
+      {
+      clause.push_back(Lit(std::abs(dimacs) - 1, dimacs < 0));
+      }
+    if (!stream || dimacs != 0 || clause.empty())
+      {
+      return false;
+      }
+    learnts.push_back(clause);
+    }
+  return true;
+  }
+
+void WarmStart::save(const std::string& filename) const
+  {
+  std::ofstream file(filename);
+  file << magic << '\n' << fingerprint << '\n' << model.size() << '\n';
+  for (const std::string& entry : model)
+    {
+    file << entry << '\n';
+    }
+  for (const std::vector<Lit>& clause : learnts)
+    {
+    for (Lit p : clause)
+      {
+      file << toDimacs(p) << ' ';
+      }
+    file << "0\n";
+    }
+  }
+
+std::string key(const KImplementation& impl)
+  {
+  std::string result = impl.id + ' ' + impl.component + ' ' + impl.version;
+  if (impl.variant)
+    {
+    for (const auto& entry : *impl.variant)
+      {
+      result += ' ' + entry.first + '=' + entry.second;
+      }
+    }
+  return result;
+  }
+
+// FNV-1a over the variables and clauses.
+std::uint64_t fingerprint(const Formula& formula)
+  {
+  std::uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](std::uint64_t value)
+    {
+    hash = (hash ^ value) * 1099511628211ull;
+    };
+  for (int v = 0; v < formula.nVars(); ++v)
+    {
+    add(formula.decision(v));
+    }
+  for (const std::vector<Lit>& clause : formula.clauses)
+    {
+    add(clause.size());
+    for (Lit p : clause)
+      {
+      add(index(p));
+      }
+    }
+  return hash;
+  }
+
+} // namespace Karrot
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_WARM_START_HPP
+#define KARROT_WARM_START_HPP
+
+#include "database.hpp"
+#include "simplify.hpp"
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Karrot
+{
+
+// What one run of the solver leaves for the next one. Learnt clauses are
+// only valid for the formula they were learnt from, so they are keyed by
+// its fingerprint. The model is stored by implementation instead of by
+// variable; it still serves as phase hints after the database has changed.
+class WarmStart
+  {
+  public:
+    WarmStart();
+    // Returns false if the file is missing or malformed.
+    bool load(const std::string& filename);
+    void save(const std::string& filename) const;
+  public:
+    std::uint64_t fingerprint;
+    std::set<std::string> model;  // see key()
+    std::vector<std::vector<Lit>> learnts;
+  };
+
+// Identifies an implementation across databases: id, component, version and
+// variant.
+std::string key(const KImplementation& impl);
+
+std::uint64_t fingerprint(const Formula& formula);
+
+} // namespace Karrot
+
+#endif /* KARROT_WARM_START_HPP */
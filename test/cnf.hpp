@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef KARROT_TEST_CNF_HPP
+#define KARROT_TEST_CNF_HPP
+
+#include "../src/minisat/Solver.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Small random CNF formulas and brute-force reference results for the tests
+// of the SAT layer.
+
+typedef std::vector<std::vector<Lit>> Clauses;
+
+inline void no_log(char const*)
+  {
+  }
+
+// A clause of 'size' random literals over the variables below 'vars'.
+inline std::vector<Lit> random_clause(std::mt19937& random, int vars, int size)
+  {
+  std::vector<Lit> clause;
+  for (int k = 0; k < size; ++k)
+    {
+    clause.push_back(Lit(random() % vars, random() % 2));
+    }
+  return clause;
+  }
+
+// 'count' random clauses of three literals over the variables below 'vars'.
+inline Clauses random_cnf(std::mt19937& random, int vars, int count)
+  {
+  Clauses clauses;
+  for (int c = 0; c < count; ++c)
+    {
+    clauses.push_back(random_clause(random, vars, 3));
+    }
+  return clauses;
+  }
+
+// The preference stack 0, ..., vars - 1 in random order.
+inline std::vector<Var> random_preferences(std::mt19937& random, int vars)
+  {
+  std::vector<Var> preferences(vars);
+  for (Var v = 0; v < vars; ++v)
+    {
+    preferences[v] = v;
+    }
+  std::shuffle(preferences.begin(), preferences.end(), random);
+  return preferences;
+  }
+
+// Adds the variables below 'vars' and 'clauses' to 'solver'.
+inline void load(const Clauses& clauses, int vars, Solver& solver)
+  {
+  for (int v = 0; v < vars; ++v)
+    {
+    solver.newVar();
+    }
+  for (const std::vector<Lit>& lits : clauses)
+    {
+    vec<Lit> clause;
+    for (Lit p : lits)
+      {
+      clause.push(p);
+      }
+    solver.addClause(clause);
+    }
+  }
+
+// Whether every clause has a true literal; unassigned literals are not.
+inline bool satisfied(const Clauses& clauses, const vec<lbool>& model)
+  {
+  for (const std::vector<Lit>& clause : clauses)
+    {
+    bool result = false;
+    for (Lit p : clause)
+      {
+      result = result || (model[var(p)] == (sign(p) ? l_False : l_True));
+      }
+    if (!result)
+      {
+      return false;
+      }
+    }
+  return true;
+  }
+
+// The assignment of the variables below 'vars' given by the bits of 'bits'.
+inline void assign(vec<lbool>& model, int vars, unsigned int bits)
+  {
+  model.clear();
+  for (int v = 0; v < vars; ++v)
+    {
+    model.push((bits >> v) & 1 ? l_True : l_False);
+    }
+  }
+
+// The model that decides the variables of 'preferences' from last to first
+// on false whenever possible, found by enumerating every assignment.
+inline bool least_model(
+    const Clauses& clauses,
+    const std::vector<Var>& preferences,
+    std::vector<bool>& result)
+  {
+  const int vars = preferences.size();
+  vec<lbool> model;
+  for (unsigned int key = 0; key < (1u << vars); ++key)
+    {
+    unsigned int bits = 0;
+    for (int k = 0; k < vars; ++k)
+      {
+      bits |= ((key >> (vars - 1 - k)) & 1) << preferences[vars - 1 - k];
+      }
+    assign(model, vars, bits);
+    if (satisfied(clauses, model))
+      {
+      result.clear();
+      for (int v = 0; v < vars; ++v)
+        {
+        result.push_back(model[v] == l_True);
+        }
+      return true;
+      }
+    }
+  return false;
+  }
+
+#endif /* KARROT_TEST_CNF_HPP */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/core.cpp"
+#include "cnf.hpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+using Karrot::minimize_core;
+
+// Whether the groups of 'groups' with their bit set in 'members' are
+// satisfiable together, found by enumerating every assignment.
+static bool satisfiable(const std::vector<Clauses>& groups, unsigned int members, int vars)
+  {
+  Clauses clauses;
+  for (std::size_t g = 0; g < groups.size(); ++g)
+    {
+    if ((members >> g) & 1)
+      {
+      clauses.insert(clauses.end(), groups[g].begin(), groups[g].end());
+      }
+    }
+  vec<lbool> model;
+  for (unsigned int bits = 0; bits < (1u << vars); ++bits)
+    {
+    assign(model, vars, bits);
+    if (satisfied(clauses, model))
+      {
+      return true;
+      }
+    }
+  return false;
+  }
+
+// Guards each group with a selector 's', as in (~s | c1 | ... | cn), like
+// the groups that explain a failed resolve. The selector of group 'g' is
+// variable 'vars + g'.
+static void load_groups(const std::vector<Clauses>& groups, int vars, Solver& solver)
+  {
+  load(Clauses(), vars, solver);
+  for (std::size_t g = 0; g < groups.size(); ++g)
+    {
+    const Var selector = solver.newVar(false);
+    for (const std::vector<Lit>& lits : groups[g])
+      {
+      vec<Lit> clause;
+      clause.push(~Lit(selector));
+      for (Lit p : lits)
+        {
+        clause.push(p);
+        }
+      solver.addClause(clause);
+      }
+    }
+  }
+
+// The groups whose selectors are in 'core', as bits.
+static unsigned int members(const vec<Lit>& core, int vars)
+  {
+  unsigned int result = 0;
+  for (int i = 0; i < core.size(); ++i)
+    {
+    BOOST_TEST(!sign(core[i]) && var(core[i]) >= vars);
+    result |= 1u << (var(core[i]) - vars);
+    }
+  return result;
+  }
+
+int core(int argc, char* argv[])
+  {
+  std::mt19937 random(42);
+  int unsatisfiable = 0;
+  int exhausted = 0;
+  for (int round = 0; round < 400; ++round)
+    {
+    const int vars = 3 + random() % 6;
+    std::vector<Clauses> groups(3 + random() % 6);
+    for (Clauses& group : groups)
+      {
+      const int size = 1 + random() % 3;
+      for (int c = 0; c < size; ++c)
+        {
+        group.push_back(random_clause(random, vars, 1 + random() % 2));
+        }
+      }
+    const unsigned int all = (1u << groups.size()) - 1;
+    if (satisfiable(groups, all, vars))
+      {
+      continue;
+      }
+    ++unsatisfiable;
+
+    // Without a budget, the core is minimal: it is unsatisfiable, and
+    // dropping any one member makes it satisfiable.
+    for (int budget = 0; budget < 2; ++budget)
+      {
+      Solver solver{random_preferences(random, vars)};
+      load_groups(groups, vars, solver);
+      vec<Lit> selectors;
+      for (std::size_t g = 0; g < groups.size(); ++g)
+        {
+        selectors.push(Lit(vars + g));
+        }
+      BOOST_TEST(!solver.solve(selectors, no_log));
+      vec<Lit> core;
+      for (int i = 0; i < solver.conflict.size(); ++i)
+        {
+        core.push(~solver.conflict[i]);
+        }
+      if (budget)
+        {
+        solver.conflict_budget = 0;
+        }
+      const bool minimal = minimize_core(solver, core, -1, no_log);
+      const unsigned int result = members(core, vars);
+      BOOST_TEST(!satisfiable(groups, result, vars));
+      if (!budget)
+        {
+        BOOST_TEST(minimal);
+        }
+      else if (!minimal)
+        {
+        ++exhausted;
+        }
+      for (std::size_t g = 0; minimal && g < groups.size(); ++g)
+        {
+        if ((result >> g) & 1)
+          {
+          BOOST_TEST(satisfiable(groups, result & ~(1u << g), vars));
+          }
+        }
+      }
+    }
+  BOOST_TEST(unsatisfiable > 50);
+  BOOST_TEST(exhausted > 0);
+  return boost::report_errors();
+  }
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/dimacs.cpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <cstdio>
+#include <fstream>
+
+using Karrot::Instance;
+using Karrot::read_dimacs;
+using Karrot::write_dimacs;
+
+static void write_file(const char* filename, const char* content)
+  {
+  std::ofstream file(filename);
+  file << content;
+  }
+
+int dimacs(int argc, char* argv[])
+  {
+  const char* filename = "dimacs_test.cnf";
+
+  Instance instance;
+  Var a = instance.formula.newVar();
+  Var b = instance.formula.newVar(false);
+  Var c = instance.formula.newVar();
+  instance.formula.addBinary(Lit(a), ~Lit(b));
+  instance.formula.addUnit(~Lit(c));
+  instance.formula.clauses.push_back(std::vector<Lit>{Lit(a), Lit(b), Lit(c)});
+  instance.preferences = {c, a};
+  instance.assumptions = {~Lit(a)};
+
+  write_dimacs(filename, instance);
+  Instance copy = read_dimacs(filename);
+  BOOST_TEST_EQ(copy.formula.nVars(), 3);
+  BOOST_TEST(copy.formula.decision(a));
+  BOOST_TEST(!copy.formula.decision(b));
+  BOOST_TEST(copy.formula.decision(c));
+  BOOST_TEST(copy.formula.clauses == instance.formula.clauses);
+  BOOST_TEST(copy.preferences == instance.preferences);
+  BOOST_TEST(copy.assumptions == instance.assumptions);
+
+  // plain DIMACS, with a clause spanning two lines
+  write_file(filename, "c comment\np cnf 2 2\n1 -2\n0 2 0\n");
+  copy = read_dimacs(filename);
+  BOOST_TEST_EQ(copy.formula.nVars(), 2);
+  BOOST_TEST_EQ(copy.formula.clauses.size(), 2u);
+  BOOST_TEST(copy.formula.decision(1));
+  BOOST_TEST(copy.preferences.empty());
+  BOOST_TEST(copy.assumptions.empty());
+
+  write_file(filename, "1 2 0\n");
+  BOOST_TEST_THROWS(read_dimacs(filename), std::runtime_error);
+  write_file(filename, "p cnf 2 1\n1 3 0\n");
+  BOOST_TEST_THROWS(read_dimacs(filename), std::runtime_error);
+  write_file(filename, "p cnf 2 2\n1 2 0\n");
+  BOOST_TEST_THROWS(read_dimacs(filename), std::runtime_error);
+  write_file(filename, "p cnf 2 1\n1 x 0\n");
+  BOOST_TEST_THROWS(read_dimacs(filename), std::runtime_error);
+
+  std::remove(filename);
+  BOOST_TEST_THROWS(read_dimacs(filename), std::runtime_error);
+
+  return boost::report_errors();
+  }
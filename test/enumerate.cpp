@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/enumerate.cpp"
+#include "cnf.hpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+using Karrot::enumerate;
+
+// The true variables of 'model' below 'vars' as bits.
+static unsigned int selection(const vec<lbool>& model, int vars)
+  {
+  unsigned int bits = 0;
+  for (int v = 0; v < vars; ++v)
+    {
+    bits |= model[v] == l_True ? 1u << v : 0;
+    }
+  return bits;
+  }
+
+int enumerate(int argc, char* argv[])
+  {
+  std::mt19937 random(42);
+  for (int round = 0; round < 200; ++round)
+    {
+    const int vars = 4 + random() % 7;
+    const std::vector<Var> preferences = random_preferences(random, vars);
+    const Clauses clauses = random_cnf(random, vars, vars * 2);
+    std::vector<bool> least;
+    if (!least_model(clauses, preferences, least))
+      {
+      continue;
+      }
+
+    Solver solver{std::vector<Var>(preferences)};
+    load(clauses, vars, solver);
+    vec<Lit> assumptions;
+    BOOST_TEST(solver.solve(assumptions, no_log));
+    std::vector<unsigned int> found{selection(solver.model, vars)};
+    vec<lbool> first;
+    solver.model.copyTo(first);
+
+    // Each call starts over from the first model; the second one checks
+    // that the blocking clauses of the first are gone.
+    for (int pass = 0; pass < 2; ++pass)
+      {
+      found.resize(1);
+      const int count = enumerate(solver, assumptions, vars, first, 1 << vars, -1, no_log,
+        [&](const vec<lbool>& model)
+        {
+        BOOST_TEST(satisfied(clauses, model));
+        found.push_back(selection(model, vars));
+        });
+      BOOST_TEST_EQ(count + 1, (int)found.size());
+      BOOST_TEST_EQ(solver.nVars(), vars + 1);
+
+      // neither equal to nor a superset of an earlier selection
+      for (std::size_t i = 1; i < found.size(); ++i)
+        {
+        for (std::size_t k = 0; k < i; ++k)
+          {
+          BOOST_TEST((found[i] & found[k]) != found[k]);
+          }
+        }
+
+      // every model contains one of the selections, since the
+      // enumeration ran to the end
+      vec<lbool> model;
+      for (unsigned int bits = 0; bits < (1u << vars); ++bits)
+        {
+        assign(model, vars, bits);
+        if (satisfied(clauses, model))
+          {
+          bool covered = false;
+          for (unsigned int selected : found)
+            {
+            covered = covered || (bits & selected) == selected;
+            }
+          BOOST_TEST(covered);
+          }
+        }
+
+      // the solver is still usable and returns the least model again
+      BOOST_TEST(solver.solve(assumptions, no_log));
+      for (Var v = 0; v < vars; ++v)
+        {
+        BOOST_TEST_EQ(solver.model[v] == l_True, least[v]);
+        }
+      BOOST_TEST_EQ(solver.nVars(), vars + 1);
+      }
+
+    // the count limits the number of further models
+    BOOST_TEST(enumerate(solver, assumptions, vars, first, 1, -1, no_log,
+      [](const vec<lbool>&)
+      {
+      }) <= 1);
+    BOOST_TEST_EQ(solver.nVars(), vars + 1);
+    }
+  return boost::report_errors();
+  }
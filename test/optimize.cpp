@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/optimize.cpp"
+#include "cnf.hpp"
+#include <boost/detail/lightweight_test.hpp>
+
+using namespace Karrot;
+
+// The least cost of a model, found by enumerating every assignment, or -1
+// if there is none.
+static int least_cost(const Clauses& clauses, const std::vector<int>& weights)
+  {
+  const int vars = weights.size();
+  int result = -1;
+  for (unsigned int key = 0; key < (1u << vars); ++key)
+    {
+    vec<lbool> model;
+    assign(model, vars, key);
+    if (satisfied(clauses, model) && (result < 0 || cost(weights, model) < result))
+      {
+      result = cost(weights, model);
+      }
+    }
+  return result;
+  }
+
+int optimize(int argc, char* argv[])
+  {
+  std::mt19937 random(42);
+  for (int round = 0; round < 200; ++round)
+    {
+    const int vars = 6 + random() % 9;
+    const Clauses clauses = random_cnf(random, vars, vars * 3);
+    // Multiples of 3, so that the weights are scaled down.
+    std::vector<int> weights(vars);
+    for (int& weight : weights)
+      {
+      weight = 3 * (random() % 5);
+      }
+
+    std::vector<Var> preferences(vars);
+    for (Var v = 0; v < vars; ++v)
+      {
+      preferences[v] = v;
+      }
+    Solver solver(std::move(preferences));
+    load(clauses, vars, solver);
+    vec<Lit> assumptions;
+    vec<lbool> model;
+    bool optimal;
+    const lbool status = minimize(solver, assumptions, weights, -1, no_log, model, optimal);
+    const int expected = least_cost(clauses, weights);
+    BOOST_TEST((status == l_True) == (expected >= 0));
+    if (status == l_True)
+      {
+      BOOST_TEST(optimal);
+      BOOST_TEST(satisfied(clauses, model));
+      BOOST_TEST_EQ(cost(weights, model), expected);
+      }
+    }
+
+  // Each pair (x, y) needs one true variable, so the first model is already
+  // optimal. Proving it takes more than the one conflict that the budget
+  // allows, so the model is returned as not optimal.
+  const int pairs = 12;
+  Clauses clauses;
+  for (int i = 0; i < pairs; ++i)
+    {
+    clauses.push_back({Lit(2 * i), Lit(2 * i + 1)});
+    }
+  std::vector<int> weights(2 * pairs, 2);
+  std::vector<Var> preferences;
+  for (Var v = 0; v < 2 * pairs; ++v)
+    {
+    preferences.push_back(v);
+    }
+  Solver solver(std::move(preferences));
+  load(clauses, 2 * pairs, solver);
+  solver.conflict_budget = 1;
+  vec<Lit> assumptions;
+  vec<lbool> model;
+  bool optimal;
+  BOOST_TEST(minimize(solver, assumptions, weights, -1, no_log, model, optimal) == l_True);
+  BOOST_TEST(!optimal);
+  BOOST_TEST(satisfied(clauses, model));
+  BOOST_TEST_EQ(cost(weights, model), 2 * pairs);
+  return boost::report_errors();
+  }
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/portfolio.cpp"
+#include "cnf.hpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <algorithm>
+#include <vector>
+
+using Karrot::Formula;
+using Karrot::load;
+using Karrot::solve_portfolio;
+
+int portfolio(int argc, char* argv[])
+  {
+  std::mt19937 random(7);
+  int satisfiable = 0;
+  for (int round = 0; round < 40; ++round)
+    {
+    const int vars = 40 + random() % 40;
+    Formula formula;
+    for (int v = 0; v < vars; ++v)
+      {
+      formula.newVar();
+      }
+    const std::vector<Var> preferences = random_preferences(random, vars);
+    formula.clauses = random_cnf(random, vars, vars * 4);
+    vec<Lit> assumptions;
+
+    Solver single{std::vector<Var>(preferences)};
+    load(formula, single);
+    if (!single.solve(assumptions, no_log))
+      {
+      continue;
+      }
+    ++satisfiable;
+    std::vector<lbool> expected(&single.model[0], &single.model[0] + vars);
+    for (int run = 0; run < 8; ++run)
+      {
+      vec<lbool> model;
+      SolverStats stats;
+      const lbool result = solve_portfolio(formula, preferences, assumptions,
+        4, -1, -1, nullptr, no_log, model, stats);
+      BOOST_TEST(result == l_True);
+      BOOST_TEST(result != l_True || std::equal(expected.begin(), expected.end(), &model[0]));
+      }
+    }
+  BOOST_TEST(satisfiable > 10);
+  return boost::report_errors();
+  }
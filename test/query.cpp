@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/query.cpp"
+#include "../src/index.cpp"
+#include "../src/implementation.cpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using Karrot::Candidate;
+using Karrot::Candidates;
+using Karrot::Database;
+using Karrot::ProjectIndex;
+using Karrot::Query;
+using Karrot::Spec;
+using Karrot::VersionKey;
+using Karrot::VersionRange;
+
+// Versions that order equal but are different strings, like "1.0" and
+// "1.00", and random ones.
+static std::string random_version(std::mt19937& random)
+  {
+  static const char* const pool[] =
+    {
+    "1", "1.0", "1.00", "1.01", "1.1", "1.10", "1.9", "2", "2.0", "2.0rc1",
+    "10", "0.9a",
+    };
+  const std::size_t size = sizeof(pool) / sizeof(pool[0]);
+  if (random() % 2)
+    {
+    return pool[random() % size];
+    }
+  const char alphabet[] = "0129.a";
+  std::string version(1, alphabet[random() % 4]);
+  for (std::size_t k = random() % 4; k > 0; --k)
+    {
+    version += alphabet[random() % (sizeof(alphabet) - 1)];
+    }
+  return version;
+  }
+
+static std::string random_os(std::mt19937& random)
+  {
+  static const char* const values[] = {"linux", "windows", "*"};
+  return values[random() % 3];
+  }
+
+// A random query of tests on the version and on "os", nested up to 'depth'.
+static std::string random_query(std::mt19937& random, int depth)
+  {
+  if (depth > 0 && random() % 3 != 0)
+    {
+    return "(" + random_query(random, depth - 1) + ")"
+      + (random() % 2 ? "&&" : "||")
+      + "(" + random_query(random, depth - 1) + ")";
+    }
+  static const char* const relations[] = {"<", "<=", ">", ">=", "==", "!="};
+  if (random() % 4 == 0)
+    {
+    return std::string("os") + relations[4 + random() % 2] + random_os(random);
+    }
+  std::string version = random() % 8 == 0 ? "*" : random_version(random);
+  return std::string("version") + relations[random() % 6] + version;
+  }
+
+static Candidate make_candidate(const std::string& version, const std::string& os)
+  {
+  KDictionary variant;
+  variant["os"] = os;
+  return Candidate(version, variant);
+  }
+
+static bool contains(const Query& query, const std::string& version)
+  {
+  return query.version_range().contains(VersionKey(version.c_str()));
+  }
+
+int query(int argc, char* argv[])
+  {
+  // The range is a superset: strict bounds are inclusive, disjunctions give
+  // the hull, and "!=" or a wildcard do not bound the version at all.
+  BOOST_TEST(contains(Query("version>1.0"), "1.0"));
+  BOOST_TEST(contains(Query("version<1.0"), "1.0"));
+  BOOST_TEST(!contains(Query("version>1.0"), "0.9"));
+  BOOST_TEST(contains(Query("version!=1.0"), "1.0"));
+  BOOST_TEST(contains(Query("version==*"), "0.9"));
+  BOOST_TEST(contains(Query("version<1.0||version>2.0"), "1.5"));
+  BOOST_TEST(contains(Query("(version>=1&&version<=2)||(version>=3&&version<=4)"), "2.5"));
+  BOOST_TEST(!contains(Query("(version>=1&&version<=2)||(version>=3&&version<=4)"), "5"));
+  BOOST_TEST(!contains(Query("version>=2&&version<=1"), "1.5"));
+  BOOST_TEST(contains(Query("version>=2&&version<=1||os==linux"), "1.5"));
+  BOOST_TEST(contains(Query("os==linux"), "0.9"));
+
+  // "version==1.0" compares strings, but the range compares version keys
+  Query equal("version==1.0");
+  BOOST_TEST(equal.evaluate(make_candidate("1.0", "linux")));
+  BOOST_TEST(!equal.evaluate(make_candidate("1.00", "linux")));
+  BOOST_TEST(contains(equal, "1.00"));
+  BOOST_TEST(!contains(equal, "1.1"));
+
+  // Every candidate that satisfies the query is in its range. Wildcard
+  // versions are not; the index evaluates them separately.
+  std::mt19937 random(42);
+  int bounded = 0;
+  for (int round = 0; round < 2000; ++round)
+    {
+    const std::string string = random_query(random, 3);
+    const Query query(string);
+    const VersionRange range = query.version_range();
+    bounded += range.empty || range.has_lower || range.has_upper;
+    for (int k = 0; k < 50; ++k)
+      {
+      const Candidate candidate = make_candidate(random_version(random), random_os(random));
+      if (query.evaluate(candidate) && !range.contains(candidate.version_key))
+        {
+        BOOST_ERROR(("range of '" + string + "' misses '"
+          + Karrot::quark_to_string(candidate.version) + "'").c_str());
+        }
+      }
+    }
+  BOOST_TEST(bounded > 500);
+
+  // ProjectIndex::query returns the same implementations as a linear scan
+  // that evaluates the query on each of them.
+  static const char* const ids[] = {"http://x/a", "http://x/b"};
+  static const char* const components[] = {"runtime", "dev", "*", "SOURCE"};
+  for (int round = 0; round < 100; ++round)
+    {
+    Database database;
+    Candidates candidates;
+    for (int i = 1 + random() % 40; i > 0; --i)
+      {
+      KDictionary variant;
+      variant["os"] = random_os(random);
+      std::string version = random() % 10 == 0 ? "*" : random_version(random);
+      database.emplace_back(ids[random() % 2], "name", components[random() % 4],
+        version, Karrot::intern_variant(variant));
+      candidates.emplace_back(version, variant);
+      }
+    ProjectIndex index(database, candidates);
+    for (int k = 0; k < 20; ++k)
+      {
+      const std::string string = random() % 10 == 0 ? "" : random_query(random, 2);
+      const Spec spec("http://x/" + std::string(1, "abc"[random() % 3]),
+        components[random() % 2], string);
+      std::vector<int> expected{-1};
+      for (std::size_t i = 0; i < database.size(); ++i)
+        {
+        const std::string& component = database[i].component;
+        if (database[i].id == spec.id
+          && (component == spec.component || component == "*" || component == "SOURCE")
+          && spec.query.evaluate(candidates[i]))
+          {
+          expected.push_back(i);
+          }
+        }
+      std::vector<int> result{-1};
+      index.query(spec, result);
+      if (result != expected)
+        {
+        BOOST_ERROR(("index query '" + string + "' differs from the scan").c_str());
+        }
+      }
+    }
+
+  return boost::report_errors();
+  }
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/simplify.cpp"
+#include "cnf.hpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <set>
+#include <vector>
+
+using Karrot::Formula;
+using Karrot::Simplifier;
+
+// The projections onto the frozen variables of all models, computed by
+// enumerating every assignment.
+static std::set<unsigned int> projections(
+    const Clauses& clauses, int vars, unsigned int frozen)
+  {
+  std::set<unsigned int> result;
+  vec<lbool> model;
+  for (unsigned int bits = 0; bits < (1u << vars); ++bits)
+    {
+    assign(model, vars, bits);
+    if (satisfied(clauses, model))
+      {
+      result.insert(bits & frozen);
+      }
+    }
+  return result;
+  }
+
+int simplify(int argc, char* argv[])
+  {
+  std::mt19937 random(42);
+  for (int round = 0; round < 500; ++round)
+    {
+    const int vars = 2 + random() % 9;
+    unsigned int frozen = 0;
+    std::vector<bool> frozen_vars;
+    Formula formula;
+    for (int v = 0; v < vars; ++v)
+      {
+      const bool decision = random() % 3 == 0;
+      formula.newVar(decision);
+      frozen_vars.push_back(decision);
+      frozen |= decision ? 1u << v : 0;
+      }
+    const int clauses = random() % (3 * vars);
+    for (int c = 0; c < clauses; ++c)
+      {
+      formula.clauses.push_back(random_clause(random, vars, 1 + random() % 3));
+      }
+
+    const Clauses original = formula.clauses;
+    const std::set<unsigned int> expected = projections(original, vars, frozen);
+
+    Simplifier simplifier(formula, frozen_vars);
+    if (!simplifier.simplify())
+      {
+      BOOST_TEST(expected.empty());
+      continue;
+      }
+
+    // frozen variables keep exactly the same set of models
+    BOOST_TEST(projections(formula.clauses, vars, frozen) == expected);
+
+    // every model of the simplified formula extends to the original one
+    vec<lbool> model;
+    for (unsigned int bits = 0; bits < (1u << vars); ++bits)
+      {
+      assign(model, vars, bits);
+      if (satisfied(formula.clauses, model))
+        {
+        simplifier.extend(model);
+        BOOST_TEST(satisfied(original, model));
+        }
+      }
+    }
+
+  // a chain of equivalences collapses onto the frozen variable
+  Formula chain;
+  Var a = chain.newVar(true);
+  Var b = chain.newVar(false);
+  Var c = chain.newVar(false);
+  chain.addBinary(~Lit(a), Lit(b));
+  chain.addBinary(~Lit(b), Lit(a));
+  chain.addBinary(~Lit(b), Lit(c));
+  chain.addBinary(~Lit(c), Lit(b));
+  Simplifier simplifier(chain, std::vector<bool>{true, false, false});
+  BOOST_TEST(simplifier.simplify());
+  BOOST_TEST(chain.clauses.empty());
+  vec<lbool> model;
+  model.push(l_True);
+  model.push(l_Undef);
+  model.push(l_Undef);
+  simplifier.extend(model);
+  BOOST_TEST(model[b] == l_True);
+  BOOST_TEST(model[c] == l_True);
+
+  // an eliminated variable next to a frozen non-decision variable that the
+  // solver leaves unassigned, which counts as false
+  Formula aux;
+  Var x = aux.newVar(false);
+  Var u = aux.newVar(false);
+  Var d = aux.newVar(true);
+  aux.addBinary(Lit(x), ~Lit(u));
+  aux.addBinary(~Lit(x), Lit(d));
+  const Clauses original = aux.clauses;
+  Simplifier eliminate(aux, std::vector<bool>{false, true, true});
+  BOOST_TEST(eliminate.simplify());
+  model.clear();
+  model.push(l_Undef);
+  model.push(l_Undef);
+  model.push(l_False);
+  eliminate.extend(model);
+  BOOST_TEST(model[x] != l_True);
+  for (Var v : {x, u})
+    {
+    model[v] = model[v] == l_Undef ? l_False : model[v];
+    }
+  BOOST_TEST(satisfied(original, model));
+
+  return boost::report_errors();
+  }
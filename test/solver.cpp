@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/minisat/Solver.cpp"
+#include "cnf.hpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <vector>
+
+static bool solve(
+    const Clauses& clauses,
+    const std::vector<Var>& preferences,
+    bool modern,
+    const vec<Lit>& earlier,
+    std::vector<bool>& result)
+  {
+  Solver solver{std::vector<Var>(preferences)};
+  solver.dynamic_order = modern;
+  solver.phase_saving = modern;
+  solver.luby_restarts = modern;
+  solver.lbd_reduction = modern;
+  load(clauses, preferences.size(), solver);
+  // A search under other assumptions leaves learnt clauses behind.
+  solver.solve(earlier, no_log);
+  if (!solver.solve(no_log))
+    {
+    return false;
+    }
+  result.clear();
+  for (std::size_t v = 0; v < preferences.size(); ++v)
+    {
+    result.push_back(solver.model[v] == l_True);
+    }
+  return true;
+  }
+
+// Adds each group of 'temporary' clauses behind an activation variable,
+// solves under it and releases the variable again. Each result must be the
+// least model of 'clauses' and the current group alone, although all groups
+// share the same variable.
+static void solve_temporary(
+    const Clauses& clauses,
+    const std::vector<Var>& preferences,
+    const std::vector<Clauses>& temporary)
+  {
+  const int vars = preferences.size();
+  Solver solver{std::vector<Var>(preferences)};
+  load(clauses, vars, solver);
+  for (const Clauses& group : temporary)
+    {
+    if (!solver.okay())
+      {
+      return;
+      }
+    const Var active = solver.newVar(false);
+    BOOST_TEST_EQ(active, vars);
+    for (const std::vector<Lit>& lits : group)
+      {
+      vec<Lit> clause;
+      clause.push(~Lit(active));
+      for (Lit p : lits)
+        {
+        clause.push(p);
+        }
+      solver.addClause(clause);
+      }
+    Clauses all(clauses);
+    all.insert(all.end(), group.begin(), group.end());
+    std::vector<bool> expected;
+    vec<Lit> assumptions;
+    assumptions.push(Lit(active));
+    const bool satisfiable = least_model(all, preferences, expected);
+    BOOST_TEST_EQ(solver.solve(assumptions, no_log), satisfiable);
+    for (Var v = 0; satisfiable && v < vars; ++v)
+      {
+      BOOST_TEST_EQ(solver.model[v] == l_True, expected[v]);
+      }
+    solver.releaseVar(~Lit(active));
+    }
+  }
+
+int solver(int argc, char* argv[])
+  {
+  std::mt19937 random(42);
+  for (int round = 0; round < 300; ++round)
+    {
+    const int vars = 6 + random() % 9;
+    const std::vector<Var> preferences = random_preferences(random, vars);
+    const Clauses clauses = random_cnf(random, vars, vars * 4);
+    vec<Lit> earlier;
+    for (Lit p : random_clause(random, vars, 3))
+      {
+      earlier.push(p);
+      }
+
+    std::vector<bool> expected;
+    const bool satisfiable = least_model(clauses, preferences, expected);
+    for (int mode = 0; mode < 4; ++mode)
+      {
+      std::vector<bool> model;
+      vec<Lit> assumptions;
+      if (mode & 2)
+        {
+        earlier.copyTo(assumptions);
+        }
+      BOOST_TEST_EQ(solve(clauses, preferences, mode & 1, assumptions, model), satisfiable);
+      BOOST_TEST(!satisfiable || model == expected);
+      }
+
+    std::vector<Clauses> temporary(3);
+    for (Clauses& group : temporary)
+      {
+      for (int c = 0; c < vars / 2; ++c)
+        {
+        group.push_back(random_clause(random, vars, 2));
+        }
+      }
+    solve_temporary(clauses, preferences, temporary);
+    }
+  return boost::report_errors();
+  }
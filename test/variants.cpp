@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/variants.cpp"
+#include <boost/detail/lightweight_test.hpp>
+
+int variants(int argc, char* argv[])
+  {
+  using Karrot::VariantEnumerator;
+  using Karrot::parse_variant;
+
+  const KDictionary* variant1 = parse_variant("os=linux;arch=x64");
+  BOOST_TEST_EQ(variant1->size(), 2u);
+  BOOST_TEST_EQ(variant1->at("os"), "linux");
+  BOOST_TEST_EQ(variant1->at("arch"), "x64");
+  BOOST_TEST(parse_variant("os=linux;arch=x64") == variant1);
+  BOOST_TEST(parse_variant("arch=x64;os=linux") == variant1);
+  BOOST_TEST(parse_variant("os=linux;arch=x64;") == variant1);
+  BOOST_TEST_EQ(parse_variant("os=linux;=x64")->size(), 1u);
+  BOOST_TEST_THROWS(parse_variant("1os=linux"), std::runtime_error);
+  BOOST_TEST_THROWS(parse_variant(""), std::runtime_error);
+
+  KDictionary axes;
+  axes["arch"] = "x86;x64";
+  axes["os"] = "linux;;windows;mac";
+
+  std::vector<std::string> expected
+    {
+    "x86 linux", "x86 windows", "x86 mac",
+    "x64 linux", "x64 windows", "x64 mac",
+    };
+  VariantEnumerator enumerator(axes);
+  const KDictionary& variant = enumerator.current();
+  for (int pass = 0; pass < 2; ++pass)
+    {
+    std::vector<std::string> result;
+    do
+      {
+      result.push_back(variant.at("arch") + ' ' + variant.at("os"));
+      }
+    while (enumerator.next());
+    BOOST_TEST(result == expected);
+    }
+
+  // The quarks follow the current combination.
+  do
+    {
+    std::vector<std::pair<int, int>> quarks;
+    for (auto& entry : variant)
+      {
+      quarks.emplace_back(Karrot::to_quark(entry.first), Karrot::to_quark(entry.second));
+      }
+    BOOST_TEST(enumerator.quarks() == quarks);
+    }
+  while (enumerator.next());
+
+  bool nonempty = enumerator.restrict(
+    [](const std::string& key, const std::string& value)
+    {
+    return key != "os" || value != "windows";
+    });
+  BOOST_TEST(nonempty);
+  std::vector<std::string> restricted;
+  do
+    {
+    restricted.push_back(variant.at("arch") + ' ' + variant.at("os"));
+    BOOST_TEST_EQ(enumerator.quarks()[1].second, Karrot::to_quark(variant.at("os")));
+    }
+  while (enumerator.next());
+  BOOST_TEST((restricted == std::vector<std::string>
+    {
+    "x86 linux", "x86 mac", "x64 linux", "x64 mac",
+    }));
+  BOOST_TEST(!enumerator.restrict(
+    [](const std::string& key, const std::string& value)
+    {
+    return key != "arch";
+    }));
+
+  VariantEnumerator empty((KDictionary()));
+  BOOST_TEST(empty.current().empty());
+  BOOST_TEST(!empty.next());
+
+  return boost::report_errors();
+  }
@@ -8,6 +8,14 @@
 
 #include "../src/vercmp.cpp"
 #include <boost/detail/lightweight_test.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+static int sign(int value)
+  {
+  return value < 0 ? -1 : value > 0 ? 1 : 0;
+  }
 
 int vercmp(int argc, char* argv[])
   {
@@ -26,5 +34,40 @@ int vercmp(int argc, char* argv[])
   BOOST_TEST(Karrot::vercmp(version2, version1) >= 0);
   BOOST_TEST(Karrot::vercmp(version2, version1) > 0);
 
+  // VersionKey must order exactly like vercmp
+  std::vector<std::string> versions
+    {
+    "", ".", "..", "0", "00", "1", "01", "1.0", "1.0.", "1.0-", "1..0", ".1",
+    "1a", "1.a", "1.0a", "1.0.a", "a", "ab", "abc", "b", "1.10", "1.9",
+    "2.0rc1", "2.0", "2.0.1", "10", "9", "1.0~beta", "1.0_beta",
+    "123456789012345678901234567890", "123456789012345678901234567891",
+    std::string(300, '7'), std::string(299, '9'), std::string(300, '7') + "a",
+    };
+  std::mt19937 generator(42);
+  const char alphabet[] = "0019abz.-";
+  for (int i = 0; i < 2000; ++i)
+    {
+    std::string version;
+    std::size_t length = generator() % 8;
+    for (std::size_t k = 0; k < length; ++k)
+      {
+      version += alphabet[generator() % (sizeof(alphabet) - 1)];
+      }
+    versions.push_back(version);
+    }
+  std::vector<Karrot::VersionKey> keys;
+  for (const std::string& version : versions)
+    {
+    keys.emplace_back(version.c_str());
+    }
+  for (std::size_t i = 0; i < versions.size(); ++i)
+    {
+    for (std::size_t k = 0; k < versions.size(); k += 1 + i % 7)
+      {
+      int expected = sign(Karrot::vercmp(versions[i].c_str(), versions[k].c_str()));
+      BOOST_TEST_EQ(keys[i].compare(keys[k]), expected);
+      }
+    }
+
   return boost::report_errors();
   }
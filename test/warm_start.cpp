@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "../src/warm_start.cpp"
+#include <boost/detail/lightweight_test.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using Karrot::Formula;
+using Karrot::WarmStart;
+
+static const char* const filename = "karrot_warm_start_test.txt";
+
+static bool load_text(const std::string& text)
+  {
+  std::ofstream(filename) << text;
+  WarmStart warm;
+  return warm.load(filename);
+  }
+
+int warm_start(int argc, char* argv[])
+  {
+  // round trip
+  WarmStart saved;
+  saved.fingerprint = 18446744073709551557ull;
+  saved.model.insert("http://x/a runtime 1.0 os=linux");
+  saved.model.insert("http://x/b SOURCE 2.0");
+  saved.learnts.push_back(std::vector<Lit>{Lit(0), ~Lit(1)});
+  saved.learnts.push_back(std::vector<Lit>{~Lit(41)});
+  saved.save(filename);
+  WarmStart loaded;
+  BOOST_TEST(loaded.load(filename));
+  BOOST_TEST_EQ(loaded.fingerprint, saved.fingerprint);
+  BOOST_TEST(loaded.model == saved.model);
+  BOOST_TEST(loaded.learnts == saved.learnts);
+
+  WarmStart empty;
+  empty.save(filename);
+  WarmStart reloaded;
+  BOOST_TEST(reloaded.load(filename));
+  BOOST_TEST(reloaded.model.empty() && reloaded.learnts.empty());
+
+  // malformed files are rejected
+  std::remove(filename);
+  BOOST_TEST(!WarmStart().load(filename));
+  BOOST_TEST(!load_text(""));
+  BOOST_TEST(!load_text("karrot-warm-start-0\n1\n0\n"));
+  BOOST_TEST(!load_text("karrot-warm-start-1\nx\n0\n"));
+  BOOST_TEST(!load_text("karrot-warm-start-1\n1\n2\nhttp://x/a runtime 1.0\n"));
+  BOOST_TEST(!load_text("karrot-warm-start-1\n1\n0\n1 -2\n"));
+  BOOST_TEST(!load_text("karrot-warm-start-1\n1\n0\n1 x 0\n"));
+  BOOST_TEST(!load_text("karrot-warm-start-1\n1\n0\n0\n"));
+  BOOST_TEST(load_text("karrot-warm-start-1\n1\n0\n1 -2 0\n"));
+  std::remove(filename);
+
+  // the fingerprint changes with every clause and decision flag
+  Formula formula;
+  formula.newVar();
+  formula.newVar();
+  formula.newVar(false);
+  formula.addBinary(Lit(0), ~Lit(1));
+  formula.addUnit(Lit(2));
+  const std::uint64_t original = Karrot::fingerprint(formula);
+  BOOST_TEST_EQ(Karrot::fingerprint(formula), original);
+
+  Formula changed = formula;
+  changed.clauses[0][1] = Lit(1);
+  BOOST_TEST(Karrot::fingerprint(changed) != original);
+
+  changed = formula;
+  changed.clauses[1].push_back(Lit(0));
+  BOOST_TEST(Karrot::fingerprint(changed) != original);
+
+  changed = formula;
+  changed.addUnit(Lit(1));
+  BOOST_TEST(Karrot::fingerprint(changed) != original);
+
+  changed = formula;
+  changed.clauses.pop_back();
+  BOOST_TEST(Karrot::fingerprint(changed) != original);
+
+  // the same literals split into other clauses
+  changed = formula;
+  changed.clauses[0].pop_back();
+  changed.clauses[1].insert(changed.clauses[1].begin(), ~Lit(1));
+  BOOST_TEST(Karrot::fingerprint(changed) != original);
+
+  Formula decisions;
+  decisions.newVar();
+  decisions.newVar();
+  decisions.newVar(true);
+  decisions.clauses = formula.clauses;
+  BOOST_TEST(Karrot::fingerprint(decisions) != original);
+
+  Formula more;
+  more.newVar();
+  more.newVar();
+  more.newVar(false);
+  more.newVar(false);
+  more.clauses = formula.clauses;
+  BOOST_TEST(Karrot::fingerprint(more) != original);
+
+  return boost::report_errors();
+  }
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2013 Daniel Pfeifer <daniel@pfeifer-mail.de>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file LICENSE_1_0.txt or copy at
+ *   http://www.boost.org/LICENSE_1_0.txt
+ */
+
+// Solves SAT instances written with K_OPT_DIMACS_FILENAME and prints one
+// line per file: the result, the best and median time over all repetitions
+// in milliseconds, and the restarts, decisions, propagations and conflicts
+// of the last repetition.
+
+#include "dimacs.hpp"
+#include "portfolio.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Karrot;
+
+class Options
+  {
+  public:
+    Options()
+      : modern_search(false)
+      , portfolio(0)
+      , repeat(1)
+      , conflict_limit(0)
+      {
+      }
+  public:
+    bool modern_search;
+    int portfolio;
+    int repeat;
+    int conflict_limit;
+    std::vector<std::string> files;
+  };
+
+static void no_log(char const*)
+  {
+  }
+
+static void usage()
+  {
+  std::cerr
+    << "usage: karrot_sat_replay [options] file...\n"
+    << "  -m, --modern-search       use activity based decisions and restarts\n"
+    << "  -p, --portfolio N         number of parallel solvers\n"
+    << "  -r, --repeat N            solve each file N times\n"
+    << "  -c, --conflict-limit N    give up after N conflicts\n"
+    ;
+  }
+
+static bool parse(int argc, char* argv[], Options& options)
+  {
+  for (int i = 1; i < argc; ++i)
+    {
+    const std::string arg = argv[i];
+    int* value = nullptr;
+    if (arg == "-m" || arg == "--modern-search")
+      {
+      options.modern_search = true;
+      }
+    else if (arg == "-p" || arg == "--portfolio")
+      {
+      value = &options.portfolio;
+      }
+    else if (arg == "-r" || arg == "--repeat")
+      {
+      value = &options.repeat;
+      }
+    else if (arg == "-c" || arg == "--conflict-limit")
+      {
+      value = &options.conflict_limit;
+      }
+    else if (arg[0] == '-')
+      {
+      return false;
+      }
+    else
+      {
+      options.files.push_back(arg);
+      }
+    if (value)
+      {
+      if (++i == argc)
+        {
+        return false;
+        }
+      *value = std::atoi(argv[i]);
+      }
+    }
+  return !options.files.empty() && options.repeat > 0;
+  }
+
+static lbool replay(
+    const Instance& instance,
+    const Options& options,
+    vec<lbool>& model,
+    SolverStats& stats)
+  {
+  vec<Lit> assumptions;
+  for (Lit p : instance.assumptions)
+    {
+    assumptions.push(p);
+    }
+  const int64 conflict_budget =
+    options.conflict_limit > 0 ? options.conflict_limit : -1;
+  if (options.portfolio > 1)
+    {
+    stats = SolverStats();
+    return solve_portfolio(instance.formula, instance.preferences, assumptions,
+      options.portfolio, conflict_budget, -1, nullptr, no_log, model, stats);
+    }
+  Solver solver(std::vector<Var>(instance.preferences));
+  solver.dynamic_order = options.modern_search;
+  solver.phase_saving = options.modern_search;
+  solver.luby_restarts = options.modern_search;
+  solver.lbd_reduction = options.modern_search;
+  solver.conflict_budget = conflict_budget;
+  load(instance.formula, solver);
+  const lbool result = solver.solveLimited(assumptions, no_log);
+  solver.model.copyTo(model);
+  stats = solver.stats;
+  return result;
+  }
+
+// Like the solver, counts non-decision variables that are left unassigned
+// as false.
+static bool satisfies(const Instance& instance, const vec<lbool>& model)
+  {
+  auto value = [&model](Lit p)
+    {
+    return (model[var(p)] == l_True) != sign(p);
+    };
+  for (const std::vector<Lit>& clause : instance.formula.clauses)
+    {
+    if (std::none_of(clause.begin(), clause.end(), value))
+      {
+      return false;
+      }
+    }
+  return std::all_of(instance.assumptions.begin(), instance.assumptions.end(), value);
+  }
+
+int main(int argc, char* argv[])
+  {
+  Options options;
+  if (!parse(argc, argv, options))
+    {
+    usage();
+    return -1;
+    }
+  int errors = 0;
+  double total = 0;
+  for (const std::string& file : options.files)
+    {
+    try
+      {
+      const Instance instance = read_dimacs(file);
+      std::vector<double> times;
+      lbool result = l_Undef;
+      vec<lbool> model;
+      SolverStats stats;
+      for (int i = 0; i < options.repeat; ++i)
+        {
+        auto start = std::chrono::steady_clock::now();
+        result = replay(instance, options, model, stats);
+        std::chrono::duration<double, std::milli> time =
+          std::chrono::steady_clock::now() - start;
+        times.push_back(time.count());
+        }
+      std::sort(times.begin(), times.end());
+      total += times.front();
+      const char* status =
+        result == l_True ? "SAT" : result == l_False ? "UNSAT" : "UNKNOWN";
+      if (result == l_True && !satisfies(instance, model))
+        {
+        status = "WRONG";
+        ++errors;
+        }
+      std::cout << file << '\t' << status
+        << std::fixed << std::setprecision(3)
+        << '\t' << times.front() << '\t' << times[times.size() / 2]
+        << '\t' << stats.starts << '\t' << stats.decisions
+        << '\t' << stats.propagations << '\t' << stats.conflicts
+        << std::endl;
+      }
+    catch (std::exception& error)
+      {
+      std::cerr << error.what() << std::endl;
+      ++errors;
+      }
+    }
+  std::cout << "total\t" << std::fixed << std::setprecision(3) << total << std::endl;
+  return errors == 0 ? 0 : 1;
+  }